@@ -13,6 +13,7 @@
 
 #include <ctbignum/bigint.hpp>
 #include <ctbignum/montgomery.hpp>
+#include <ctbignum/view.hpp>
 #include <ctbignum/decimal_literals.hpp>
 
 #include <libff/algebra/fields/fp.hpp>
@@ -21,7 +22,8 @@
 using namespace cbn::literals;
 
 
-template <size_t Len> static void montmul_cbn(benchmark::State &state) {
+template <size_t Len, typename Policy = cbn::operand_scanning>
+static void montmul_cbn(benchmark::State &state) {
 
   using namespace cbn;
 
@@ -38,11 +40,12 @@ template <size_t Len> static void montmul_cbn(benchmark::State &state) {
 
   for (auto _ : state) {
 
-    auto x = reinterpret_cast<big_int<Len> *>(base_ptr + i);
-    auto y = reinterpret_cast<big_int<Len> *>(base_ptr + i + Len);
+    auto x = big_int_view<Len, const uint64_t>(base_ptr + i);
+    auto y = big_int_view<Len, const uint64_t>(base_ptr + i + Len);
     auto j = cbn::montgomery_mul(
-        *x, *y,
-        14474011154664524427946373126085988481658748083205070504932198000989141205031_Z);
+        x.load(), y.load(),
+        14474011154664524427946373126085988481658748083205070504932198000989141205031_Z,
+        Policy{});
     benchmark::DoNotOptimize(j);
 
     i += 2 * Len;
@@ -51,6 +54,54 @@ template <size_t Len> static void montmul_cbn(benchmark::State &state) {
   }
 }
 
+template <size_t Len, size_t Streams> static void montmul_cbn_streams(benchmark::State &state) {
+
+  // throughput of 4 independent Montgomery multiplications, either through
+  // montgomery_mul_x2 / montgomery_mul_x4 (Streams = 2, 4), which make K
+  // independent scalar calls, or one by one (Streams = 1)
+
+  using namespace cbn;
+
+  size_t total_sz = 8 * Len * 1000;
+
+  std::vector<uint64_t> data(total_sz);
+  std::default_random_engine generator;
+  std::uniform_int_distribution<uint64_t> distribution(0);
+  for (auto &limb : data)
+    limb = distribution(generator) >> 4; // below the modulus
+
+  constexpr auto modulus =
+      14474011154664524427946373126085988481658748083205070504932198000989141205031_Z;
+
+  size_t i = 0;
+  auto base_ptr = data.data();
+
+  for (auto _ : state) {
+
+    auto x = reinterpret_cast<big_int<Len> *>(base_ptr + i);
+    if constexpr (Streams == 4) {
+      auto r = cbn::montgomery_mul_x4(x[0], x[1], x[2], x[3], x[4], x[5], x[6],
+                                      x[7], modulus);
+      benchmark::DoNotOptimize(r);
+    } else if constexpr (Streams == 2) {
+      auto r = cbn::montgomery_mul_x2(x[0], x[1], x[2], x[3], modulus);
+      auto r2 = cbn::montgomery_mul_x2(x[4], x[5], x[6], x[7], modulus);
+      benchmark::DoNotOptimize(r);
+      benchmark::DoNotOptimize(r2);
+    } else {
+      for (auto s = 0; s < 4; ++s) {
+        auto r = cbn::montgomery_mul(x[2 * s], x[2 * s + 1], modulus);
+        benchmark::DoNotOptimize(r);
+      }
+    }
+
+    i += 8 * Len;
+    if (i == total_sz)
+      i = 0;
+  }
+  state.SetItemsProcessed(4 * state.iterations());
+}
+
 static auto mymodulus = libff::bigint<4>("14474011154664524427946373126085988481658748083205070504932198000989141205031");
 
 template <size_t Len> static void montmul_libff_t(benchmark::State &state) {
@@ -87,5 +138,9 @@ template <size_t Len> static void montmul_libff_t(benchmark::State &state) {
 }
 
 BENCHMARK_TEMPLATE(montmul_cbn,4);
+BENCHMARK_TEMPLATE(montmul_cbn,4,cbn::product_scanning);
+BENCHMARK_TEMPLATE(montmul_cbn_streams,4,1);
+BENCHMARK_TEMPLATE(montmul_cbn_streams,4,2);
+BENCHMARK_TEMPLATE(montmul_cbn_streams,4,4);
 BENCHMARK_TEMPLATE(montmul_libff_t,4);
 BENCHMARK_MAIN();
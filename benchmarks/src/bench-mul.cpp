@@ -54,7 +54,7 @@ static void mul_gmp(benchmark::State &state) {
 
 
 
-template <size_t Len>
+template <size_t Len, typename Policy = cbn::operand_scanning>
 static void mul_cbn(benchmark::State &state) {
 
   using namespace cbn;
@@ -75,7 +75,7 @@ static void mul_cbn(benchmark::State &state) {
 
     auto x = reinterpret_cast<big_int<Len>*>(base_ptr + i);
     auto y = reinterpret_cast<big_int<Len>*>(base_ptr + i + Len);
-    auto j = cbn::mul(*x, *y);
+    auto j = cbn::mul(*x, *y, Policy{});
     benchmark::DoNotOptimize(j);
 
     i += 2 * Len;
@@ -125,30 +125,37 @@ static void mul_ntl(benchmark::State &state) {
 
 
 BENCHMARK_TEMPLATE(mul_cbn, 2);
+BENCHMARK_TEMPLATE(mul_cbn, 2, cbn::product_scanning);
 BENCHMARK_TEMPLATE(mul_ntl, 2);
 BENCHMARK_TEMPLATE(mul_gmp, 2);
 
 BENCHMARK_TEMPLATE(mul_cbn, 3);
+BENCHMARK_TEMPLATE(mul_cbn, 3, cbn::product_scanning);
 BENCHMARK_TEMPLATE(mul_ntl, 3);
 BENCHMARK_TEMPLATE(mul_gmp, 3);
 
 BENCHMARK_TEMPLATE(mul_cbn, 4);
+BENCHMARK_TEMPLATE(mul_cbn, 4, cbn::product_scanning);
 BENCHMARK_TEMPLATE(mul_ntl, 4);
 BENCHMARK_TEMPLATE(mul_gmp, 4);
 
 BENCHMARK_TEMPLATE(mul_cbn, 5);
+BENCHMARK_TEMPLATE(mul_cbn, 5, cbn::product_scanning);
 BENCHMARK_TEMPLATE(mul_ntl, 5);
 BENCHMARK_TEMPLATE(mul_gmp, 5);
 
 BENCHMARK_TEMPLATE(mul_cbn, 6);
+BENCHMARK_TEMPLATE(mul_cbn, 6, cbn::product_scanning);
 BENCHMARK_TEMPLATE(mul_ntl, 6);
 BENCHMARK_TEMPLATE(mul_gmp, 6);
 
 BENCHMARK_TEMPLATE(mul_cbn, 7);
+BENCHMARK_TEMPLATE(mul_cbn, 7, cbn::product_scanning);
 BENCHMARK_TEMPLATE(mul_ntl, 7);
 BENCHMARK_TEMPLATE(mul_gmp, 7);
 
 BENCHMARK_TEMPLATE(mul_cbn, 8);
+BENCHMARK_TEMPLATE(mul_cbn, 8, cbn::product_scanning);
 BENCHMARK_TEMPLATE(mul_ntl, 8);
 BENCHMARK_TEMPLATE(mul_gmp, 8);
 
@@ -118,10 +118,10 @@ BENCHMARK_F(MyFixture, fixture_mul)(benchmark::State &st) {
 
   for (auto _ : st) {
 
-    auto x = reinterpret_cast<big_int<4>*>(base_ptr + i);
-    auto y = reinterpret_cast<big_int<4>*>(base_ptr + i + 4);
+    auto x = big_int_view<4, const uint64_t>(base_ptr + i);
+    auto y = big_int_view<4, const uint64_t>(base_ptr + i + 4);
 
-    auto j = cbn::mul(*x, *y);
+    auto j = cbn::mul(x.load(), y.load());
     //auto k = cbn::barrett_reduction(j, prime);
     benchmark::DoNotOptimize(j);
 
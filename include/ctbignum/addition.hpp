@@ -15,13 +15,90 @@
 #include <ctbignum/bigint.hpp>
 #include <ctbignum/config.hpp>
 #include <ctbignum/slicing.hpp>
+#include <ctbignum/type_traits.hpp>
+#include <ctbignum/view.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
 
+#if defined(__x86_64__) && !defined(CBN_HAS_BUILTIN_ADDC)
+#include <x86intrin.h>
+#endif
 
 namespace cbn {
 
+namespace detail {
+
+template <typename T>
+CBN_ALWAYS_INLINE
+constexpr T add_carry(T a, T b, T carry_in, T &carry_out) {
+  // a + b + carry_in, for carry_in in {0, 1}; the carry is stored in carry_out
+  if (!std::is_constant_evaluated()) {
+#if defined(CBN_HAS_BUILTIN_ADDC)
+    if constexpr (std::is_same_v<T, unsigned long long>)
+      return __builtin_addcll(a, b, carry_in, &carry_out);
+    else if constexpr (std::is_same_v<T, unsigned long>)
+      return __builtin_addcl(a, b, carry_in, &carry_out);
+    else if constexpr (std::is_same_v<T, unsigned int>)
+      return __builtin_addc(a, b, carry_in, &carry_out);
+#elif defined(__x86_64__)
+    if constexpr (sizeof(T) == 8) {
+      unsigned long long res;
+      carry_out = _addcarry_u64(static_cast<unsigned char>(carry_in), a, b, &res);
+      return res;
+    } else if constexpr (sizeof(T) == 4) {
+      unsigned int res;
+      carry_out = _addcarry_u32(static_cast<unsigned char>(carry_in), a, b, &res);
+      return res;
+    }
+#endif
+  }
+
+  T sum = a + b;
+  T res = sum + carry_in;
+  carry_out = (sum < a) | (res < sum);
+  return res;
+}
+
+template <typename T>
+CBN_ALWAYS_INLINE
+constexpr T sub_borrow(T a, T b, T borrow_in, T &borrow_out) {
+  // a - b - borrow_in, for borrow_in in {0, 1}; the borrow is stored in
+  // borrow_out
+  if (!std::is_constant_evaluated()) {
+#if defined(CBN_HAS_BUILTIN_ADDC)
+    if constexpr (std::is_same_v<T, unsigned long long>)
+      return __builtin_subcll(a, b, borrow_in, &borrow_out);
+    else if constexpr (std::is_same_v<T, unsigned long>)
+      return __builtin_subcl(a, b, borrow_in, &borrow_out);
+    else if constexpr (std::is_same_v<T, unsigned int>)
+      return __builtin_subc(a, b, borrow_in, &borrow_out);
+#elif defined(__x86_64__)
+    if constexpr (sizeof(T) == 8) {
+      unsigned long long res;
+      borrow_out = _subborrow_u64(static_cast<unsigned char>(borrow_in), a, b, &res);
+      return res;
+    } else if constexpr (sizeof(T) == 4) {
+      unsigned int res;
+      borrow_out = _subborrow_u32(static_cast<unsigned char>(borrow_in), a, b, &res);
+      return res;
+    }
+#endif
+  }
+
+  T diff = a - b;
+  T res = diff - borrow_in;
+  borrow_out = (diff > a) | (res > diff);
+  return res;
+}
+
+} // end of detail namespace
+
 template <typename T, size_t M, size_t N>
 CBN_ALWAYS_INLINE
 constexpr auto add(big_int<M, T> a, big_int<N, T> b) {
@@ -43,13 +120,8 @@ constexpr auto add_same(big_int<N, T> a, big_int<N, T> b) {
   T carry{};
   big_int<N + 1, T> r{};
 
-  for (auto i = 0U; i < N; ++i) {
-    auto aa = a[i];
-    auto sum = aa + b[i];
-    auto res = sum + carry;
-    carry = (sum < aa) | (res < sum);
-    r[i] = res;
-  }
+  for (auto i = 0U; i < N; ++i)
+    r[i] = detail::add_carry(a[i], b[i], carry, carry);
 
   r[N] = carry;
   return r;
@@ -61,13 +133,8 @@ constexpr auto subtract_same(big_int<N, T> a, big_int<N, T> b) {
   T carry{};
   big_int<N + 1, T> r{};
 
-  for (auto i = 0U; i < N; ++i) {
-    auto aa = a[i];
-    auto diff = aa - b[i];
-    auto res = diff - carry;
-    carry = (diff > aa) | (res > diff);
-    r[i] = res;
-  }
+  for (auto i = 0U; i < N; ++i)
+    r[i] = detail::sub_borrow(a[i], b[i], carry, carry);
 
   r[N] = carry * static_cast<T>(-1); // sign extension
   return r;
@@ -79,13 +146,8 @@ constexpr auto add_ignore_carry(big_int<N, T> a, big_int<N, T> b) {
   T carry{};
   big_int<N, T> r{};
 
-  for (auto i = 0U; i < N; ++i) {
-    T aa = a[i];
-    T sum = aa + b[i];
-    T res = sum + carry;
-    carry = (sum < aa) | (res < sum);
-    r[i] = res;
-  }
+  for (auto i = 0U; i < N; ++i)
+    r[i] = detail::add_carry(a[i], b[i], carry, carry);
 
   return r;
 }
@@ -95,57 +157,238 @@ constexpr auto subtract_ignore_carry(big_int<N, T> a, big_int<N, T> b) {
   T carry{};
   big_int<N, T> r{};
 
-  for (auto i = 0U; i < N; ++i) {
-    auto aa = a[i];
-    auto diff = aa - b[i];
-    auto res = diff - carry;
-    carry = (diff > aa) | (res > diff);
-    r[i] = res;
-  }
+  for (auto i = 0U; i < N; ++i)
+    r[i] = detail::sub_borrow(a[i], b[i], carry, carry);
 
   return r;
 }
 
 template <typename T, size_t N>
+CBN_ALWAYS_INLINE
 constexpr auto mod_add(big_int<N, T> a, big_int<N, T> b,
                        big_int<N, T> modulus) {
+  // (a + b) mod m, for a, b < m: one addition chain, one subtraction chain
+  // (of the modulus) and a branch-free (masked) selection of the result
   T carry{};
   big_int<N, T> r{};
-
-  for (auto i = 0U; i < N; ++i) {
-    auto aa = a[i];
-    auto sum = aa + b[i];
-    auto res = sum + carry;
-    carry = (sum < aa) | (res < sum);
-    r[i] = res;
-  }
-
-  auto reduced = subtract(r, modulus);
-  T r_geq_modulus = reduced[N] ? 0 : 1;
-  big_int<N, T> res = (carry + r_geq_modulus != 0) ? detail::first<N>(reduced) : r;
-  return res;
+  for (auto i = 0U; i < N; ++i)
+    r[i] = detail::add_carry(a[i], b[i], carry, carry);
+
+  T borrow{};
+  big_int<N, T> reduced{};
+  for (auto i = 0U; i < N; ++i)
+    reduced[i] = detail::sub_borrow(r[i], modulus[i], borrow, borrow);
+
+  // select r - m if a + b >= m, i.e., if the addition carries or the
+  // subtraction does not borrow
+  T mask = -(carry | (borrow ^ 1));
+  for (auto i = 0U; i < N; ++i)
+    r[i] = (reduced[i] & mask) | (r[i] & ~mask);
+  return r;
 }
 
 template <typename T, size_t N>
+CBN_ALWAYS_INLINE
 constexpr auto mod_sub(big_int<N, T> a, big_int<N, T> b,
                        big_int<N, T> modulus) {
-  T carry{};
+  // (a - b) mod m, for a, b < m: one subtraction chain, followed by the
+  // addition of the modulus masked by the final borrow
+  T borrow{};
   big_int<N, T> r{};
+  for (auto i = 0U; i < N; ++i)
+    r[i] = detail::sub_borrow(a[i], b[i], borrow, borrow);
 
-  for (auto i = 0U; i < N; ++i) {
-    auto aa = a[i];
-    auto diff = aa - b[i];
-    auto res = diff - carry;
-    carry = (diff > aa) | (res > diff);
-    r[i] = res;
+  T mask = -borrow;
+  T carry{};
+  for (auto i = 0U; i < N; ++i)
+    r[i] = detail::add_carry(r[i], modulus[i] & mask, carry, carry);
+  return r;
+}
+
+// In-place variants, which update their first argument (a big_int, or a
+// writable big_int_view of external limbs) and avoid the by-value copies of
+// the functions above for long operands. The second argument may be a big_int
+// or a view, and may refer to the same limbs as the first.
+
+template <typename A, typename B>
+requires detail::writable_limb_sequence<A> && detail::limb_sequence<B>
+CBN_ALWAYS_INLINE
+constexpr auto add_to(A &&a, const B &b) {
+  // a += b mod (2^w)^M, returns the carry
+  using T = typename detail::limb_traits_t<A>::type;
+  constexpr auto M = detail::limb_traits_t<A>::size;
+  constexpr auto N = detail::limb_traits_t<B>::size;
+  static_assert(std::is_same_v<T, typename detail::limb_traits_t<B>::type>);
+  static_assert(M >= N, "add_to requires the target to be at least as long");
+
+  T carry{};
+  for (auto i = 0U; i < N; ++i)
+    a[i] = detail::add_carry(a[i], b[i], carry, carry);
+  for (auto i = N; i < M; ++i)
+    a[i] = detail::add_carry(a[i], T{}, carry, carry);
+  return carry;
+}
+
+template <typename A, typename B>
+requires detail::writable_limb_sequence<A> && detail::limb_sequence<B>
+CBN_ALWAYS_INLINE
+constexpr auto sub_from(A &&a, const B &b) {
+  // a -= b mod (2^w)^M, returns the borrow
+  using T = typename detail::limb_traits_t<A>::type;
+  constexpr auto M = detail::limb_traits_t<A>::size;
+  constexpr auto N = detail::limb_traits_t<B>::size;
+  static_assert(std::is_same_v<T, typename detail::limb_traits_t<B>::type>);
+  static_assert(M >= N, "sub_from requires the target to be at least as long");
+
+  T borrow{};
+  for (auto i = 0U; i < N; ++i)
+    a[i] = detail::sub_borrow(a[i], b[i], borrow, borrow);
+  for (auto i = N; i < M; ++i)
+    a[i] = detail::sub_borrow(a[i], T{}, borrow, borrow);
+  return borrow;
+}
+
+template <typename A, typename B, typename Mod>
+requires detail::writable_limb_sequence<A> && detail::limb_sequence<B> &&
+         detail::limb_sequence<Mod>
+CBN_ALWAYS_INLINE
+constexpr void mod_add_to(A &&a, const B &b, const Mod &modulus) {
+  // a = (a + b) mod m, for a, b < m (cf. mod_add)
+  using T = typename detail::limb_traits_t<A>::type;
+  constexpr auto N = detail::limb_traits_t<A>::size;
+  static_assert(N == detail::limb_traits_t<B>::size &&
+                N == detail::limb_traits_t<Mod>::size);
+
+  T carry = add_to(a, b);
+
+  T borrow{};
+  big_int<N, T> reduced{};
+  for (auto i = 0U; i < N; ++i)
+    reduced[i] = detail::sub_borrow(a[i], modulus[i], borrow, borrow);
+
+  T mask = -(carry | (borrow ^ 1));
+  for (auto i = 0U; i < N; ++i)
+    a[i] = (reduced[i] & mask) | (a[i] & ~mask);
+}
+
+template <typename A, typename B, typename Mod>
+requires detail::writable_limb_sequence<A> && detail::limb_sequence<B> &&
+         detail::limb_sequence<Mod>
+CBN_ALWAYS_INLINE
+constexpr void mod_sub_from(A &&a, const B &b, const Mod &modulus) {
+  // a = (a - b) mod m, for a, b < m (cf. mod_sub)
+  using T = typename detail::limb_traits_t<A>::type;
+  constexpr auto N = detail::limb_traits_t<A>::size;
+  static_assert(N == detail::limb_traits_t<B>::size &&
+                N == detail::limb_traits_t<Mod>::size);
+
+  T mask = -sub_from(a, b);
+  T carry{};
+  for (auto i = 0U; i < N; ++i)
+    a[i] = detail::add_carry(a[i], modulus[i] & mask, carry, carry);
+}
+
+namespace detail {
+template <typename A, typename B>
+requires writable_limb_sequence<A> && limb_sequence<B>
+CBN_ALWAYS_INLINE
+constexpr auto subtract_if_not_less(A &&a, typename limb_traits_t<A>::type hi,
+                                    const B &m) {
+  // (hi, a) -= m if (hi, a) >= m, where hi is an extra most-significant limb
+  // of a; returns the new value of hi. The difference is computed once and
+  // selected, instead of comparing first.
+  using T = typename limb_traits_t<A>::type;
+  constexpr auto M = limb_traits_t<A>::size;
+  constexpr auto N = limb_traits_t<B>::size;
+  static_assert(M >= N);
+
+  big_int<M, T> d{};
+  T borrow{};
+  for (auto i = 0U; i < N; ++i)
+    d[i] = sub_borrow(a[i], m[i], borrow, borrow);
+  for (auto i = N; i < M; ++i)
+    d[i] = sub_borrow(a[i], T{}, borrow, borrow);
+
+  // (hi, a) >= m iff the borrow out of a - m does not exceed hi
+  T mask = -static_cast<T>(hi >= borrow);
+  for (auto i = 0U; i < M; ++i)
+    a[i] = (d[i] & mask) | (a[i] & ~mask);
+  return static_cast<T>(hi - (borrow & mask));
+}
+
+template <typename T, size_t N>
+constexpr auto carry_save_sum(const big_int<N, T> *xs, std::size_t count) {
+  // the sum of count numbers (count <= 2^w), where the limbs of each column
+  // are summed in a double-width accumulator, so that the columns are
+  // independent of each other and carries are only propagated once, at the end
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+  if constexpr (w < std::numeric_limits<std::size_t>::digits)
+    if (count > (std::size_t{1} << w))
+      // (the columns and the N+1 limb result would overflow)
+      throw std::length_error("add_many supports at most 2^w operands");
+
+  std::array<TT, N> columns{};
+
+  if constexpr (std::numeric_limits<T>::digits == 64) {
+    // 128-bit additions do not vectorize: the 32-bit halves of the limbs are
+    // summed in separate 64-bit accumulators instead, which are added to the
+    // columns after (at most) every 2^32 operands
+    constexpr std::size_t block = std::size_t{1} << 32;
+    for (std::size_t start = 0; start < count; start += block) {
+      const auto end = std::min(count, start + block);
+      std::array<T, N> lo{}, hi{};
+      for (std::size_t j = start; j < end; ++j)
+        for (auto i = 0U; i < N; ++i) {
+          lo[i] += static_cast<uint32_t>(xs[j][i]);
+          hi[i] += xs[j][i] >> 32;
+        }
+      for (auto i = 0U; i < N; ++i)
+        columns[i] += lo[i] + (static_cast<TT>(hi[i]) << 32);
+    }
+  } else {
+    for (std::size_t j = 0; j < count; ++j)
+      for (auto i = 0U; i < N; ++i)
+        columns[i] += xs[j][i];
   }
 
-  auto adjusted_r = add_ignore_carry(r, modulus);
-  big_int<N, T> res = carry ? adjusted_r : r;
-  return res;
+  big_int<N + 1, T> r{};
+  TT carry = 0;
+  for (auto i = 0U; i < N; ++i) {
+    TT t = columns[i] + carry;
+    r[i] = static_cast<T>(t);
+    carry = t >> std::numeric_limits<T>::digits;
+  }
+  r[N] = static_cast<T>(carry);
+  return r;
+}
+} // end of detail namespace
+
+template <typename T, size_t N, typename... Rest>
+constexpr auto add_many(big_int<N, T> x, Rest... rest) {
+  // x + rest..., for any number of N-limb operands, as an N+1 limb number
+  static_assert((std::is_same_v<Rest, big_int<N, T>> && ...),
+                "add_many requires operands of the same type");
+  static_assert(sizeof...(Rest) <= std::numeric_limits<T>::max(),
+                "add_many supports at most 2^w operands");
+  std::array<big_int<N, T>, sizeof...(Rest) + 1> xs{x, rest...};
+  return detail::carry_save_sum(xs.data(), xs.size());
 }
 
+template <typename T, size_t N, size_t Extent>
+constexpr auto add_many(std::span<const big_int<N, T>, Extent> xs) {
+  // the sum of a range of (at most 2^w) N-limb numbers, as an N+1 limb number
+  // (throws std::length_error for longer ranges)
+  static_assert(Extent == std::dynamic_extent ||
+                    Extent - 1 <= std::numeric_limits<T>::max(),
+                "add_many supports at most 2^w operands");
+  return detail::carry_save_sum(xs.data(), xs.size());
+}
 
+template <typename T, size_t N, size_t Extent>
+constexpr auto add_many(std::span<big_int<N, T>, Extent> xs) {
+  return add_many(std::span<const big_int<N, T>, Extent>(xs));
+}
 
 template <typename T, size_t N, T... Modulus>
 constexpr auto mod_add(big_int<N, T> a, big_int<N, T> b, std::integer_sequence<T, Modulus...>) {
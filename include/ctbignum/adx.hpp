@@ -0,0 +1,392 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#ifndef CT_ADX_HPP
+#define CT_ADX_HPP
+
+#include <ctbignum/bigint.hpp>
+#include <ctbignum/config.hpp>
+#include <ctbignum/slicing.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifdef CBN_USE_ADX
+#include <immintrin.h>
+
+namespace cbn {
+namespace detail {
+
+// Run-time-only kernels for x86-64 CPUs with BMI2 (mulx) and ADX (adcx/adox).
+//
+// The low and high halves of the limb products are accumulated in two
+// independent carry chains, kept in the CF and OF flags. Compilers do not
+// keep two carry flags alive across _addcarryx_u64 intrinsics, so the kernels
+// are written as asm blocks, which are unrolled by the assembler (.rept),
+// using the (compile-time) operand lengths as immediates. Operands of at most
+// asm_max_limbs limbs get straight-line code for the whole operation.
+//
+// With a compile-time modulus, the limbs of the modulus are passed as
+// immediate operands as well (as two signed 32-bit halves, the form in which
+// GCC can print them), so that they are encoded in the instructions, and the
+// products with zero limbs are skipped.
+
+constexpr std::size_t asm_max_limbs = 8;
+
+template <std::size_t K, typename T, T... Limbs>
+constexpr T limb_or_zero =
+    K < sizeof...(Limbs) ? std::array<T, sizeof...(Limbs)>{Limbs...}[K] : T{0};
+
+template <std::size_t K, uint64_t... Limbs>
+constexpr int32_t limb_hi32 =
+    static_cast<int32_t>(limb_or_zero<K, uint64_t, Limbs...> >> 32);
+
+template <std::size_t K, uint64_t... Limbs>
+constexpr int32_t limb_lo32 =
+    static_cast<int32_t>(limb_or_zero<K, uint64_t, Limbs...>);
+
+// asm input operands [h0], [l0], ..., [h7], [l7] (the halves of the limbs)
+#define CBN_ASM_LIMB_OPERANDS(Limbs)                                           \
+  [h0] "i"(detail::limb_hi32<0, Limbs...>),                                    \
+      [l0] "i"(detail::limb_lo32<0, Limbs...>),                                \
+      [h1] "i"(detail::limb_hi32<1, Limbs...>),                                \
+      [l1] "i"(detail::limb_lo32<1, Limbs...>),                                \
+      [h2] "i"(detail::limb_hi32<2, Limbs...>),                                \
+      [l2] "i"(detail::limb_lo32<2, Limbs...>),                                \
+      [h3] "i"(detail::limb_hi32<3, Limbs...>),                                \
+      [l3] "i"(detail::limb_lo32<3, Limbs...>),                                \
+      [h4] "i"(detail::limb_hi32<4, Limbs...>),                                \
+      [l4] "i"(detail::limb_lo32<4, Limbs...>),                                \
+      [h5] "i"(detail::limb_hi32<5, Limbs...>),                                \
+      [l5] "i"(detail::limb_lo32<5, Limbs...>),                                \
+      [h6] "i"(detail::limb_hi32<6, Limbs...>),                                \
+      [l6] "i"(detail::limb_lo32<6, Limbs...>),                                \
+      [h7] "i"(detail::limb_hi32<7, Limbs...>),                                \
+      [l7] "i"(detail::limb_lo32<7, Limbs...>)
+
+// Invokes the assembler macro "name" for each limb slot, with arguments
+// (slot index, high half, low half)
+#define CBN_ASM_FOR_EACH_LIMB(name)                                            \
+  name " 0, %c[h0], %c[l0]\n\t" name " 1, %c[h1], %c[l1]\n\t" name             \
+       " 2, %c[h2], %c[l2]\n\t" name " 3, %c[h3], %c[l3]\n\t" name             \
+       " 4, %c[h4], %c[l4]\n\t" name " 5, %c[h5], %c[l5]\n\t" name             \
+       " 6, %c[h6], %c[l6]\n\t" name " 7, %c[h7], %c[l7]\n\t"
+
+template <std::size_t M>
+CBN_ALWAYS_INLINE inline uint64_t adx_addmul_row(uint64_t *w, const uint64_t *u,
+                                                 uint64_t v) {
+  // w[0..M-1] += u[0..M-1] * v, returns the carry limb
+
+  static_assert(M > 0);
+  uint64_t lo, hi, hi_prev;
+  asm("xorl %k[hp], %k[hp]\n\t" // also clears CF and OF
+      ".set cbn_i, 0\n\t"
+      ".rept %c[len]\n\t"
+      "mulxq 8*cbn_i(%[u]), %[lo], %[hi]\n\t"
+      "adcxq 8*cbn_i(%[w]), %[lo]\n\t"
+      "adoxq %[hp], %[lo]\n\t"
+      "movq %[lo], 8*cbn_i(%[w])\n\t"
+      "movq %[hi], %[hp]\n\t"
+      ".set cbn_i, cbn_i + 1\n\t"
+      ".endr\n\t"
+      "movl $0, %k[lo]\n\t"
+      "adcxq %[lo], %[hp]\n\t"
+      "adoxq %[lo], %[hp]"
+      : [lo] "=&r"(lo), [hi] "=&r"(hi), [hp] "=&r"(hi_prev),
+        "+m"(*reinterpret_cast<uint64_t(*)[M]>(w))
+      : [w] "r"(w), [u] "r"(u), "d"(v), [len] "i"(M),
+        "m"(*reinterpret_cast<const uint64_t(*)[M]>(u))
+      : "cc");
+  return hi_prev;
+}
+
+template <std::size_t M>
+CBN_ALWAYS_INLINE inline uint64_t
+adx_addmul_shift_row(uint64_t *w, const uint64_t *u, uint64_t v) {
+  // (w[0..M-1] + u[0..M-1] * v) / 2^64, where the division is exact; the low
+  // M-1 limbs of the quotient are stored in w[0..M-2], its top limb is returned
+
+  static_assert(M > 0);
+  uint64_t lo, hi, hi_prev;
+  asm("xorl %k[lo], %k[lo]\n\t" // clears CF and OF
+      "mulxq (%[u]), %[lo], %[hp]\n\t"
+      "adcxq (%[w]), %[lo]\n\t"
+      ".set cbn_i, 1\n\t"
+      ".rept %c[len] - 1\n\t"
+      "mulxq 8*cbn_i(%[u]), %[lo], %[hi]\n\t"
+      "adcxq 8*cbn_i(%[w]), %[lo]\n\t"
+      "adoxq %[hp], %[lo]\n\t"
+      "movq %[lo], 8*cbn_i-8(%[w])\n\t"
+      "movq %[hi], %[hp]\n\t"
+      ".set cbn_i, cbn_i + 1\n\t"
+      ".endr\n\t"
+      "movl $0, %k[lo]\n\t"
+      "adcxq %[lo], %[hp]\n\t"
+      "adoxq %[lo], %[hp]"
+      : [lo] "=&r"(lo), [hi] "=&r"(hi), [hp] "=&r"(hi_prev),
+        "+m"(*reinterpret_cast<uint64_t(*)[M]>(w))
+      : [w] "r"(w), [u] "r"(u), "d"(v), [len] "i"(M),
+        "m"(*reinterpret_cast<const uint64_t(*)[M]>(u))
+      : "cc");
+  return hi_prev;
+}
+
+template <std::size_t L, std::size_t M, std::size_t N>
+CBN_ALWAYS_INLINE inline void adx_mul_into(big_int<L, uint64_t> &w,
+                                           const big_int<M, uint64_t> &u,
+                                           const big_int<N, uint64_t> &v) {
+  // w += u v, where the limbs w[M..L-1] must be zero on entry
+  static_assert(L >= M + N);
+  if constexpr (std::max(M, N) <= asm_max_limbs) {
+    // straight-line code
+    uint64_t lo, hi, hi_prev;
+    asm(".set cbn_j, 0\n\t"
+        ".rept %c[n]\n\t"
+        "movq 8*cbn_j(%[v]), %%rdx\n\t"
+        "xorl %k[hp], %k[hp]\n\t"
+        ".set cbn_i, 0\n\t"
+        ".rept %c[m]\n\t"
+        "mulxq 8*cbn_i(%[u]), %[lo], %[hi]\n\t"
+        "adcxq 8*(cbn_i + cbn_j)(%[w]), %[lo]\n\t"
+        "adoxq %[hp], %[lo]\n\t"
+        "movq %[lo], 8*(cbn_i + cbn_j)(%[w])\n\t"
+        "movq %[hi], %[hp]\n\t"
+        ".set cbn_i, cbn_i + 1\n\t"
+        ".endr\n\t"
+        "movl $0, %k[lo]\n\t"
+        "adcxq %[lo], %[hp]\n\t"
+        "adoxq %[lo], %[hp]\n\t"
+        "movq %[hp], 8*(cbn_j + %c[m])(%[w])\n\t"
+        ".set cbn_j, cbn_j + 1\n\t"
+        ".endr"
+        : [lo] "=&r"(lo), [hi] "=&r"(hi), [hp] "=&r"(hi_prev), "+m"(w)
+        : [w] "r"(w.data()), [u] "r"(u.data()), [v] "r"(v.data()), "m"(u),
+          "m"(v), [m] "i"(M), [n] "i"(N)
+        : "rdx", "cc");
+  } else {
+    for (std::size_t j = 0; j < N; ++j)
+      w[j + M] = adx_addmul_row<M>(&w[j], u.data(), v[j]);
+  }
+}
+
+template <std::size_t padding_limbs, std::size_t M, std::size_t N>
+CBN_ALWAYS_INLINE inline auto adx_mul(const big_int<M, uint64_t> &u,
+                                      const big_int<N, uint64_t> &v) {
+  big_int<M + N + padding_limbs, uint64_t> w{};
+  adx_mul_into(w, u, v);
+  return w;
+}
+
+template <std::size_t R, std::size_t J, std::size_t M, std::size_t N>
+CBN_ALWAYS_INLINE inline void adx_partial_mul_row(big_int<R, uint64_t> &w,
+                                                  const big_int<M, uint64_t> &u,
+                                                  const big_int<N, uint64_t> &v) {
+  // w += u v[J] (2^64)^J mod (2^64)^R
+  constexpr auto L = std::min(M, R - J);
+  auto carry = adx_addmul_row<L>(&w[J], u.data(), v[J]);
+  if constexpr (J + L < R)
+    w[J + L] = carry;
+}
+
+template <std::size_t R, std::size_t M, std::size_t N, std::size_t... J>
+CBN_ALWAYS_INLINE inline auto
+adx_partial_mul(const big_int<M, uint64_t> &u, const big_int<N, uint64_t> &v,
+                std::index_sequence<J...>) {
+  big_int<R, uint64_t> w{};
+  (adx_partial_mul_row<R, J>(w, u, v), ...);
+  return w;
+}
+
+template <std::size_t R, std::size_t M, std::size_t N>
+CBN_ALWAYS_INLINE inline auto adx_partial_mul(const big_int<M, uint64_t> &u,
+                                              const big_int<N, uint64_t> &v) {
+  // the R least-significant limbs of u v
+  return adx_partial_mul<R>(u, v, std::make_index_sequence<std::min(N, R)>{});
+}
+
+template <std::size_t N>
+CBN_ALWAYS_INLINE inline auto adx_square(const big_int<N, uint64_t> &a) {
+  // a^2, straight-line code: the cross products a[i] a[j] (i < j) are
+  // accumulated first, after which the sum is doubled and the squares a[i]^2
+  // are added (the doubling and the addition each use one carry chain)
+
+  static_assert(N >= 2 && N <= asm_max_limbs);
+  big_int<2 * N, uint64_t> w{};
+  uint64_t lo, hi, hi_prev;
+  asm(".set cbn_i, 0\n\t"
+      ".rept %c[n] - 1\n\t"
+      "movq 8*cbn_i(%[a]), %%rdx\n\t"
+      "xorl %k[hp], %k[hp]\n\t"
+      ".set cbn_j, cbn_i + 1\n\t"
+      ".rept %c[n] - 1 - cbn_i\n\t"
+      "mulxq 8*cbn_j(%[a]), %[lo], %[hi]\n\t"
+      "adcxq 8*(cbn_i + cbn_j)(%[w]), %[lo]\n\t"
+      "adoxq %[hp], %[lo]\n\t"
+      "movq %[lo], 8*(cbn_i + cbn_j)(%[w])\n\t"
+      "movq %[hi], %[hp]\n\t"
+      ".set cbn_j, cbn_j + 1\n\t"
+      ".endr\n\t"
+      "movl $0, %k[lo]\n\t"
+      "adcxq %[lo], %[hp]\n\t"
+      "adoxq %[lo], %[hp]\n\t"
+      "movq %[hp], 8*(cbn_i + %c[n])(%[w])\n\t"
+      ".set cbn_i, cbn_i + 1\n\t"
+      ".endr\n\t"
+      // w = 2 w + sum_i a[i]^2 (2^64)^2i
+      "xorl %k[hp], %k[hp]\n\t"
+      ".set cbn_i, 0\n\t"
+      ".rept %c[n]\n\t"
+      "movq 8*cbn_i(%[a]), %%rdx\n\t"
+      "mulxq %%rdx, %[lo], %[hi]\n\t"
+      "movq 16*cbn_i(%[w]), %[hp]\n\t"
+      "adcxq %[hp], %[hp]\n\t"
+      "adoxq %[lo], %[hp]\n\t"
+      "movq %[hp], 16*cbn_i(%[w])\n\t"
+      "movq 16*cbn_i + 8(%[w]), %[hp]\n\t"
+      "adcxq %[hp], %[hp]\n\t"
+      "adoxq %[hi], %[hp]\n\t"
+      "movq %[hp], 16*cbn_i + 8(%[w])\n\t"
+      ".set cbn_i, cbn_i + 1\n\t"
+      ".endr"
+      : [lo] "=&r"(lo), [hi] "=&r"(hi), [hp] "=&r"(hi_prev), "+m"(w)
+      : [w] "r"(w.data()), [a] "r"(a.data()), "m"(a), [n] "i"(N)
+      : "rdx", "cc");
+  return w;
+}
+
+template <std::size_t N>
+CBN_ALWAYS_INLINE inline auto
+adx_conditional_subtract(const big_int<N + 1, uint64_t> &A,
+                         const big_int<N, uint64_t> &m) {
+  // A mod m, for A < 2m
+  big_int<N, uint64_t> r{};
+  unsigned char borrow = 0;
+  for (std::size_t j = 0; j < N; ++j) {
+    unsigned long long d;
+    borrow = _subborrow_u64(borrow, A[j], m[j], &d);
+    r[j] = d;
+  }
+  bool keep_A = (A[N] == 0) & (borrow != 0); // A < m
+  for (std::size_t j = 0; j < N; ++j)
+    r[j] = keep_A ? A[j] : r[j];
+  return r;
+}
+
+template <std::size_t N>
+CBN_ALWAYS_INLINE inline auto
+adx_montgomery_mul(const big_int<N, uint64_t> &x, const big_int<N, uint64_t> &y,
+                   const big_int<N, uint64_t> &m, uint64_t mprime) {
+  // Montgomery multiplication (CIOS), returns x y R^-1 mod m
+
+  using TT = __uint128_t;
+  big_int<N + 1, uint64_t> A{};
+
+  for (std::size_t i = 0; i < N; ++i) {
+    // A += x[i] * y
+    TT top = static_cast<TT>(A[N]) + adx_addmul_row<N>(A.data(), y.data(), x[i]);
+    A[N] = static_cast<uint64_t>(top);
+    uint64_t A_extra = top >> 64;
+
+    // A += u_i * m followed by a 1 limb-shift to the right
+    uint64_t u_i = A[0] * mprime;
+    top = static_cast<TT>(A[N]) + adx_addmul_shift_row<N>(A.data(), m.data(), u_i);
+    A[N - 1] = static_cast<uint64_t>(top);
+    A[N] = A_extra + static_cast<uint64_t>(top >> 64);
+  }
+
+  return adx_conditional_subtract<N>(A, m);
+}
+
+template <uint64_t... Modulus>
+CBN_ALWAYS_INLINE inline auto
+adx_montgomery_mul(const big_int<sizeof...(Modulus), uint64_t> &x,
+                   const big_int<sizeof...(Modulus), uint64_t> &y,
+                   uint64_t mprime) {
+  // Montgomery multiplication (CIOS) with a compile-time modulus, as
+  // straight-line code in which the limbs of the modulus are immediates
+  // (products with zero limbs are skipped)
+
+  constexpr auto N = sizeof...(Modulus);
+  static_assert(N <= asm_max_limbs);
+
+  big_int<N + 2, uint64_t> A{};
+  uint64_t lo, hi, hi_prev;
+  asm(".macro cbn_mul_limb k, mh, ml\n\t"
+      ".if \\k < %c[len]\n\t"
+      ".if (\\mh == 0) && (\\ml == 0)\n\t"
+      "movl $0, %k[lo]\n\t"
+      "movl $0, %k[hi]\n\t"
+      ".else\n\t"
+      "movabsq $((\\mh << 32) | (\\ml & 0xffffffff)), %[lo]\n\t"
+      "mulxq %[lo], %[lo], %[hi]\n\t"
+      ".endif\n\t"
+      "adcxq 8*\\k(%[A]), %[lo]\n\t"
+      "adoxq %[hp], %[lo]\n\t"
+      ".if \\k > 0\n\t"
+      "movq %[lo], 8*\\k-8(%[A])\n\t"
+      ".endif\n\t"
+      "movq %[hi], %[hp]\n\t"
+      ".endif\n\t"
+      ".endm\n\t"
+      ".set cbn_i, 0\n\t"
+      ".rept %c[len]\n\t"
+      // A += x[i] * y
+      "movq 8*cbn_i(%[x]), %%rdx\n\t"
+      "xorl %k[hp], %k[hp]\n\t"
+      ".set cbn_j, 0\n\t"
+      ".rept %c[len]\n\t"
+      "mulxq 8*cbn_j(%[y]), %[lo], %[hi]\n\t"
+      "adcxq 8*cbn_j(%[A]), %[lo]\n\t"
+      "adoxq %[hp], %[lo]\n\t"
+      "movq %[lo], 8*cbn_j(%[A])\n\t"
+      "movq %[hi], %[hp]\n\t"
+      ".set cbn_j, cbn_j + 1\n\t"
+      ".endr\n\t"
+      "movl $0, %k[lo]\n\t"
+      "adcxq %[lo], %[hp]\n\t"
+      "adoxq %[lo], %[hp]\n\t"
+      "addq %[hp], 8*%c[len](%[A])\n\t"
+      "adcq $0, 8*%c[len]+8(%[A])\n\t"
+      // A = (A + u_i * m) / 2^64, where u_i = A[0] * mprime mod 2^64
+      "movq (%[A]), %%rdx\n\t"
+      "imulq %[mp], %%rdx\n\t"
+      "xorl %k[hp], %k[hp]\n\t"
+      CBN_ASM_FOR_EACH_LIMB("cbn_mul_limb")
+      "movl $0, %k[lo]\n\t"
+      "adcxq %[lo], %[hp]\n\t"
+      "adoxq %[lo], %[hp]\n\t"
+      "addq 8*%c[len](%[A]), %[hp]\n\t"
+      "movq %[hp], 8*%c[len]-8(%[A])\n\t"
+      "movq 8*%c[len]+8(%[A]), %[hp]\n\t"
+      "adcq $0, %[hp]\n\t"
+      "movq %[hp], 8*%c[len](%[A])\n\t"
+      "movq $0, 8*%c[len]+8(%[A])\n\t"
+      ".set cbn_i, cbn_i + 1\n\t"
+      ".endr\n\t"
+      ".purgem cbn_mul_limb"
+      : [lo] "=&r"(lo), [hi] "=&r"(hi), [hp] "=&r"(hi_prev), "+m"(A)
+      : [A] "r"(A.data()), [x] "r"(x.data()), [y] "r"(y.data()),
+        [mp] "r"(mprime), "m"(x), "m"(y), [len] "i"(N),
+        CBN_ASM_LIMB_OPERANDS(Modulus)
+      : "rdx", "cc");
+
+  return adx_conditional_subtract<N>(first<N + 1>(A),
+                                     big_int<N, uint64_t>{Modulus...});
+}
+
+} // end of detail namespace
+} // end of cbn namespace
+
+#endif // CBN_USE_ADX
+
+#endif
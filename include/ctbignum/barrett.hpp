@@ -12,6 +12,7 @@
 #define CT_BARRETT_HPP
 
 #include <algorithm>
+#include <array>
 #include <cstddef> // std::size_t
 #include <cmath>
 
@@ -21,16 +22,76 @@
 #include <ctbignum/mult.hpp>
 #include <ctbignum/relational_ops.hpp>
 #include <ctbignum/slicing.hpp>
+#include <ctbignum/view.hpp>
 
 namespace cbn {
 
 namespace detail {
 template <typename T, T... Modulus> constexpr auto precompute_mu() {
   big_int<sizeof...(Modulus), T> modulus = {Modulus...};
-  const std::size_t twoN = 2 * sizeof...(Modulus);
-  auto quot_rem = div(detail::unary_encoding<twoN, twoN + 1>(), modulus);
-  return quot_rem.quotient;
+  return reciprocal(modulus).quotient;
 }
+
+template <typename T, std::size_t N1, std::size_t N2, std::size_t N3>
+constexpr auto barrett_reduce(big_int<N1, T> x, big_int<N2, T> modulus,
+                              big_int<N3, T> mu) {
+
+  // Barrett reduction, cf. Algorithm 14.42 in "Handbook of Applied
+  // Cryptography", by Menezes, van Oorschot and Vanstone.
+  //
+  // inputs:
+  //  x        (N1 limbs)  number to be reduced, x < (2^w)^(2 N2)
+  //                       (or N1 = 2 N2 + 1 and x < 2 (2^w)^(2 N2), e.g., a
+  //                       sum of two products of reduced operands)
+  //  modulus  (N2 limbs)  m, where the most-significant limb of m is nonzero
+  //  mu                   floor((2^w)^(2 N2) / m)  (at most N2 + 1 limbs)
+  //
+  // The quotient estimate q3 = floor(q1 mu / (2^w)^(N2 + 1)), where
+  // q1 = floor(x / (2^w)^(N2 - 1)), is computed with mul_high (so only the
+  // upper part of the product q1 mu is computed). Since q3 is then at most
+  // one below the exact value of the estimate, which in turn is at most two
+  // (three, for the longer input) below floor(x / m), up to three (four)
+  // final subtractions are needed.
+
+  // The slices of x and mu are views (and the final subtractions are done in
+  // place), so that no copies of them are made.
+
+  static_assert(N1 <= 2 * N2 + 1, "barrett_reduction requires x < 2 (2^w)^(2N)");
+  static_assert(N3 >= N2 + 1, "mu has (at least) N2 + 1 limbs");
+
+  if constexpr (N1 < N2 + 1)
+    return barrett_reduce(pad<N2 + 1 - N1>(x), modulus, mu);
+  else {
+    constexpr auto Q1 = N1 - (N2 - 1); // length of q1
+    auto q3 = mul_high<Q1>(subview<N2 - 1, Q1>(x), subview<0, N2 + 1>(mu));
+
+    // r = x - q3 m mod (2^w)^(N2+1), as (hi, r[0..N2-1])
+    auto r = first<N2 + 1>(x);
+    sub_from(r, mul_low<N2 + 1>(q3, modulus));
+    auto low = subview<0, N2>(r);
+
+    constexpr auto subtractions = (N1 > 2 * N2) ? 4 : 3;
+    for (auto i = 0; i < subtractions; ++i)
+      r[N2] = subtract_if_not_less(low, r[N2], modulus);
+
+    return low.load();
+  }
+}
+
+template <std::size_t K, typename T, T... Modulus>
+constexpr auto precompute_fold_table() {
+  // (2^w)^(N + j) mod m, for 0 <= j < K
+  constexpr auto N = sizeof...(Modulus);
+  constexpr big_int<N, T> modulus = {Modulus...};
+  std::array<big_int<N, T>, K> table{};
+  auto c = div(unary_encoding<N, N + 1, T>(), modulus).remainder;
+  for (auto j = 0U; j < K; ++j) {
+    table[j] = c;
+    c = div(join(big_int<1, T>{}, c), modulus).remainder;
+  }
+  return table;
+}
+
 } // end namespace detail
 
 template <typename T, std::size_t N1, T... Modulus>
@@ -39,42 +100,43 @@ constexpr auto barrett_reduction(big_int<N1, T> x,
 
   // Barrett reduction, modulus as a template parameter.
 
-  using detail::skip;
-  using detail::first;
-  using detail::unary_encoding;
-  using detail::pad;
-
-  auto mu = detail::precompute_mu<T, Modulus...>();
-  const std::size_t N2 = sizeof...(Modulus);
-
-  constexpr auto L = std::max(static_cast<int>(0), static_cast<int>(N2)+1-static_cast<int>(N1)); 
-  auto y = pad<L>(x);
-
-  big_int<N2, T> modulus = {Modulus...};
-
-  auto q2approx = mul(skip<N2 - 1>(y),   //
-                      skip<N2 - 2>(mu)); // approximation as suggested in Ch.14
-                                         // of "Handbook of Applied Cryptography",
-                                         // by Menezes and van Oorschot
-  auto q3 = skip<3>(q2approx);           //
-
-  //auto q3 = skip<N2+1>(mul(skip<N2 - 1>(x),mu)); // this would be the exact version
-
-  auto r1 = first<N2 + 1>(y);
-  auto r2 = partial_mul<N2 + 1>(q3, modulus);
-  auto r_with_carry = subtract(r1, r2);
-  auto r = first<N2 + 1>(r_with_carry);
-
-  if (r_with_carry[N2 + 1])
-    r = add_ignore_carry(r, unary_encoding<N2, N2 + 1>());
-
-  auto padded_mod = pad<1>(modulus);
-  if (r >= padded_mod)
-    r = subtract_ignore_carry(r, padded_mod);
-  if (r >= padded_mod)
-    r = subtract_ignore_carry(r, padded_mod);
+  constexpr auto mu = detail::precompute_mu<T, Modulus...>();
+  constexpr big_int<sizeof...(Modulus), T> modulus = {Modulus...};
+  return detail::barrett_reduce(x, modulus, mu);
+}
 
-  return first<N2>(r);
+template <typename T, std::size_t N1, T... Modulus>
+constexpr auto wide_reduction(big_int<N1, T> x,
+                              std::integer_sequence<T, Modulus...>) {
+
+  // x mod m, for inputs of any length (e.g., uniformly random strings of
+  // 512 or 1024 bits, reduced into a 256-bit prime field)
+  //
+  // Each limb x_i of x above the N lower ones is folded down by adding
+  // x_i ((2^w)^i mod m) (from a compile-time table) to the lower limbs, i.e.,
+  // at the cost of a single limb-by-N-limbs multiplication. The sum has
+  // N + 2 limbs, and is reduced by a final Barrett reduction.
+
+  constexpr auto N = sizeof...(Modulus);
+  constexpr big_int<N, T> modulus = {Modulus...};
+  static_assert(N >= 2, "wide_reduction requires a modulus of at least two limbs");
+
+  if constexpr (N1 <= N + 2)
+    return barrett_reduction(x, std::integer_sequence<T, Modulus...>{});
+  else {
+    using TT = typename dbl_bitlen<T>::type;
+    constexpr auto table = detail::precompute_fold_table<N1 - N, T, Modulus...>();
+    constexpr auto mu = detail::precompute_mu<T, Modulus...>();
+
+    // acc < (N1 - N + 1) (2^w)^(N + 1)
+    auto acc = detail::take<0, N, 2>(x);
+    for (auto j = 0U; j < N1 - N; ++j) {
+      TT t = static_cast<TT>(acc[N]) + detail::addmul_row(acc, 0, table[j], x[N + j]);
+      acc[N] = static_cast<T>(t);
+      acc[N + 1] += static_cast<T>(t >> std::numeric_limits<T>::digits);
+    }
+    return detail::barrett_reduce(acc, modulus, mu);
+  }
 }
 
 // specialization for length one
@@ -92,29 +154,29 @@ constexpr auto barrett_reduction(big_int<N1, T> x, big_int<N2, T> modulus,
   // Barrett reduction, when given modulus and precomputed value mu that depends
   // on modulus as ordinary parameters.
 
-  using detail::skip;
-  using detail::first;
-  using detail::unary_encoding;
-  using detail::pad;
+  return detail::barrett_reduce(x, modulus, mu);
+}
+
+template <typename T, std::size_t N, T... Modulus>
+constexpr auto barrett_mul_add_mul(big_int<N, T> a, big_int<N, T> b,
+                                   big_int<N, T> c, big_int<N, T> d,
+                                   std::integer_sequence<T, Modulus...>) {
 
-  auto q2approx = mul(skip<N2 - 1>(x), skip<N2 - 2>(mu));
-  auto q3 = skip<3>(q2approx);
+  // (a b + c d) mod m, with a single Barrett reduction (requires a, b, c, d < m)
 
-  auto r1 = first<N2 + 1>(x);
-  auto r2 = partial_mul<N2 + 1>(q3, modulus);
-  auto r_with_carry = subtract(r1, r2);
-  auto r = first<N2 + 1>(r_with_carry);
+  constexpr auto mu = detail::precompute_mu<T, Modulus...>();
+  constexpr big_int<sizeof...(Modulus), T> modulus = {Modulus...};
+  return detail::barrett_reduce(mul_add_mul(a, b, c, d), modulus, mu);
+}
 
-  if (r_with_carry[N2 + 1])
-    r = add_ignore_carry(r, unary_encoding<N2, N2 + 1>());
+template <typename T, std::size_t N, std::size_t N3>
+constexpr auto barrett_mul_add_mul(big_int<N, T> a, big_int<N, T> b,
+                                   big_int<N, T> c, big_int<N, T> d,
+                                   big_int<N, T> modulus, big_int<N3, T> mu) {
 
-  auto padded_mod = pad<1>(modulus);
-  if (r >= padded_mod)
-    r = subtract_ignore_carry(r, padded_mod);
-  if (r >= padded_mod)
-    r = subtract_ignore_carry(r, padded_mod);
+  // (a b + c d) mod m, with a single Barrett reduction (requires a, b, c, d < m)
 
-  return first<N2>(r);
+  return detail::barrett_reduce(mul_add_mul(a, b, c, d), modulus, mu);
 }
 }
 #endif
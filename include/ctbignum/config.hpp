@@ -14,4 +14,76 @@
 
 #define CBN_ALWAYS_INLINE [[gnu::always_inline]]
 
+// Multiplications where both operands have at least this many limbs use
+// Karatsuba's method (recursively, until the operands become smaller than
+// this threshold, after which schoolbook multiplication takes over)
+#ifndef CBN_KARATSUBA_THRESHOLD
+#define CBN_KARATSUBA_THRESHOLD 24
+#endif
+
+// Products (and squares, and truncated products) of operands with 32-bit
+// limbs, where both operands have at least this many limbs, are computed with
+// delayed carry propagation: the low and high
+// halves of the 64-bit partial products are summed in separate 64-bit column
+// accumulators, and carries are only propagated once at the end. The inner
+// loops are then free of carry dependencies, so that compilers can vectorize
+// them.
+#ifndef CBN_LAZY_CARRY_THRESHOLD
+#define CBN_LAZY_CARRY_THRESHOLD 24
+#endif
+
+// Since the delayed-carry kernels are considerably faster than the ordinary
+// schoolbook kernels, Karatsuba's method only pays off for larger operands:
+// for 32-bit limbs, this threshold replaces CBN_KARATSUBA_THRESHOLD (for
+// multiplication, squaring and truncated products)
+#ifndef CBN_LAZY_CARRY_KARATSUBA_THRESHOLD
+#define CBN_LAZY_CARRY_KARATSUBA_THRESHOLD 256
+#endif
+
+// On x86-64, use the MULX/ADCX/ADOX based kernels (for mul, square and
+// montgomery_mul with 64-bit limbs) when the compiler targets a CPU that
+// supports BMI2 and ADX (e.g., -march=native, or -mbmi2 -madx). Define
+// CBN_NO_ADX to always use the portable kernels. Compile-time evaluation always
+// uses the portable code.
+#if defined(__x86_64__) && defined(__BMI2__) && defined(__ADX__) &&            \
+    !defined(CBN_NO_ADX)
+#define CBN_USE_ADX
+#endif
+
+// Carry chains (additions and subtractions) use the add-with-carry builtins of
+// the compiler where available, or else the x86 _addcarry/_subborrow
+// intrinsics, so that they are compiled to adc/sbb chains. Compile-time
+// evaluation always uses the portable code.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_addcll) && __has_builtin(__builtin_subcll)
+#define CBN_HAS_BUILTIN_ADDC
+#endif
+#endif
+
+// At run time, multiplications (and squarings) of 64-bit limb operands where
+// both operands have at least this many limbs are computed with number
+// theoretic transforms (see ntt.hpp). The default is the measured crossover
+// point with Karatsuba multiplication, which is lower for the portable kernels
+// than for the ADX kernels.
+#ifndef CBN_NTT_THRESHOLD
+#ifdef CBN_USE_ADX
+#define CBN_NTT_THRESHOLD 2048
+#else
+#define CBN_NTT_THRESHOLD 512
+#endif
+#endif
+
+// The reciprocal function (Barrett's mu and R^2 mod m, for moduli of N limbs)
+// uses Newton iteration, instead of a division by Algorithm D, from this many
+// limbs onwards. The default is the measured crossover point with the ADX
+// kernels; with the portable kernels, Algorithm D was faster for all measured
+// lengths (up to 1024 limbs).
+#ifndef CBN_NEWTON_RECIPROCAL_THRESHOLD
+#ifdef CBN_USE_ADX
+#define CBN_NEWTON_RECIPROCAL_THRESHOLD 160
+#else
+#define CBN_NEWTON_RECIPROCAL_THRESHOLD 2048
+#endif
+#endif
+
 #endif
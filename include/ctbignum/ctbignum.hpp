@@ -25,9 +25,13 @@
 #include <ctbignum/io.hpp>
 #include <ctbignum/mod_exp.hpp>
 #include <ctbignum/montgomery.hpp>
+#include <ctbignum/montgomery_context.hpp>
 #include <ctbignum/mult.hpp>
+#include <ctbignum/pseudo_mersenne.hpp>
 #include <ctbignum/relational_ops.hpp>
 #include <ctbignum/slicing.hpp>
+#include <ctbignum/solinas.hpp>
 #include <ctbignum/utility.hpp>
+#include <ctbignum/view.hpp>
 
 #endif
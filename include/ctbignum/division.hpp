@@ -15,10 +15,14 @@
 #include <ctbignum/addition.hpp>
 #include <ctbignum/bigint.hpp>
 #include <ctbignum/bitshift.hpp>
+#include <ctbignum/config.hpp>
 #include <ctbignum/mult.hpp>
+#include <ctbignum/relational_ops.hpp>
 #include <ctbignum/slicing.hpp>
 #include <ctbignum/type_traits.hpp>
 #include <ctbignum/utility.hpp>
+
+#include <bit>
 #include <limits>
 
 namespace cbn {
@@ -28,18 +32,197 @@ template <typename Q, typename R> struct DivisionResult {
   R remainder;
 };
 
-template <size_t M, typename T> constexpr  
+namespace detail {
+
+// Division by a normalized divisor (most-significant bit set) with a
+// precomputed reciprocal, cf. N. Möller and T. Granlund, "Improved division
+// by invariant integers", IEEE Transactions on Computers, 60(2), 2011.
+// The quotient limbs are obtained with multiplications only: a double-width
+// division is needed only once, for the reciprocal.
+
+template <typename T>
+constexpr T reciprocal_word(T d) {
+  // floor((B^2 - 1) / d) - B, for a normalized limb d (B = 2^w)
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+  constexpr auto all_ones = static_cast<TT>(~TT{0}); // B^2 - 1
+  return static_cast<T>(all_ones / d - (static_cast<TT>(1) << w));
+}
+
+template <typename T>
+constexpr T reciprocal_3by2(T d1, T d0) {
+  // floor((B^3 - 1) / (d1 B + d0)) - B, for a normalized divisor (d1, d0)
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+
+  T v = reciprocal_word(d1);
+  T p = static_cast<T>(d1 * v);
+  p = static_cast<T>(p + d0);
+  if (p < d0) {
+    --v;
+    if (p >= d1) {
+      --v;
+      p = static_cast<T>(p - d1);
+    }
+    p = static_cast<T>(p - d1);
+  }
+  TT t = static_cast<TT>(v) * d0;
+  T t1 = static_cast<T>(t >> w);
+  T t0 = static_cast<T>(t);
+  p = static_cast<T>(p + t1);
+  if (p < t1) {
+    --v;
+    if (p > d1 || (p == d1 && t0 >= d0))
+      --v;
+  }
+  return v;
+}
+
+template <typename T>
+CBN_ALWAYS_INLINE
+constexpr T div_2by1(T u1, T u0, T d, T v, T &r) {
+  // floor((u1 B + u0) / d), for a normalized d with reciprocal v, and u1 < d;
+  // the remainder is stored in r
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+
+  TT q = static_cast<TT>(static_cast<TT>(v) * u1 +
+                         ((static_cast<TT>(u1) << w) | u0));
+  T q1 = static_cast<T>((q >> w) + 1);
+  T q0 = static_cast<T>(q);
+  T rem = static_cast<T>(u0 - q1 * d);
+  if (rem > q0) { // unpredictable, but cheap
+    --q1;
+    rem = static_cast<T>(rem + d);
+  }
+  if (rem >= d) { // unlikely
+    ++q1;
+    rem = static_cast<T>(rem - d);
+  }
+  r = rem;
+  return q1;
+}
+
+template <typename T>
+CBN_ALWAYS_INLINE
+constexpr T div_3by2(T u2, T u1, T u0, T d1, T d0, T v, T &r1, T &r0) {
+  // floor((u2 B^2 + u1 B + u0) / (d1 B + d0)), for a normalized divisor with
+  // reciprocal v (cf. reciprocal_3by2), and (u2, u1) < (d1, d0); the
+  // remainder is stored in (r1, r0)
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto w = std::numeric_limits<T>::digits;
+
+  TT q = static_cast<TT>(static_cast<TT>(v) * u2 +
+                         ((static_cast<TT>(u2) << w) | u1));
+  T q1 = static_cast<T>(q >> w);
+  T q0 = static_cast<T>(q);
+  T rem1 = static_cast<T>(u1 - q1 * d1);
+  const TT d = (static_cast<TT>(d1) << w) | d0;
+  TT rem = static_cast<TT>(((static_cast<TT>(rem1) << w) | u0) -
+                           static_cast<TT>(d0) * q1 - d);
+  ++q1;
+  if (static_cast<T>(rem >> w) >= q0) {
+    --q1;
+    rem = static_cast<TT>(rem + d);
+  }
+  if (rem >= d) { // unlikely
+    ++q1;
+    rem = static_cast<TT>(rem - d);
+  }
+  r1 = static_cast<T>(rem >> w);
+  r0 = static_cast<T>(rem);
+  return q1;
+}
+
+template <typename T>
+CBN_ALWAYS_INLINE
+constexpr T submul_row(T *w, const T *u, std::size_t len, T v) {
+  // w[0..len-1] -= u[0..len-1] * v, returns the borrow limb (the carry of
+  // the product and the borrow of the subtraction, which together fit in a
+  // limb)
+  using TT = typename dbl_bitlen<T>::type;
+  T k = 0;
+  for (std::size_t i = 0; i < len; ++i) {
+    TT p = static_cast<TT>(u[i]) * v + k;
+    T lo = static_cast<T>(p);
+    k = static_cast<T>(p >> std::numeric_limits<T>::digits);
+    T x = w[i];
+    w[i] = static_cast<T>(x - lo);
+    k += (lo > x);
+  }
+  return k;
+}
+
+template <typename T> 
+CBN_ALWAYS_INLINE  
+constexpr T inverse_mod(T a) {
+  // inverse modulo 2^(limb-width) (needed for the montgomery representation,
+  // and for exact division)
+  T x = ((a << 1 ^ a) & 4) << 1 ^ a;
+  x += x - a * x * x;
+  if constexpr (std::numeric_limits<T>::digits >= 16) x += x - a * x * x;
+  if constexpr (std::numeric_limits<T>::digits >= 32) x += x - a * x * x;
+  if constexpr (std::numeric_limits<T>::digits >= 64) x += x - a * x * x;
+  return x;
+}
+
+// The reciprocal of a long normalized divisor, by Newton iteration, cf.
+// Algorithm 3.5 (ApproximateReciprocal) in R. Brent and P. Zimmermann, "Modern
+// Computer Arithmetic", 2010. Each step doubles the number of correct limbs,
+// at the cost of two multiplications, so that (with Karatsuba multiplication)
+// it is cheaper than a division of (2^w)^(2 N) by Algorithm D for large N.
+
+template <size_t N, typename T>
+constexpr big_int<N + 1, T> approx_reciprocal(big_int<N, T> a) {
+  // X with a X < (2^w)^(2 N) <= a (X + 2), for a normalized a (msb set),
+  // where (2^w)^N <= X < 2 (2^w)^N
+  if constexpr (N <= 2) {
+    auto all_ones = subtract_ignore_carry(big_int<2 * N, T>{}, big_int<2 * N, T>{1});
+    return first<N + 1>(div(all_ones, a).quotient);
+  } else {
+    constexpr auto L = (N - 1) / 2;
+    constexpr auto H = N - L;
+
+    // the reciprocal of the upper H limbs
+    auto x = approx_reciprocal(skip<L>(a));
+
+    // t = (2^w)^(N + H) - a x, where 0 <= t <= 2 a. As a x - (2^w)^(N + H)
+    // lies in (-2 a, 2 (2^w)^N), only the lower N + 1 limbs of a x are needed
+    constexpr auto w = std::numeric_limits<T>::digits;
+    auto ax = partial_mul<N + 1>(a, x);
+    while (!(ax[N] >> (w - 1))) { // a x >= (2^w)^(N + H), at most twice
+      x = subtract_ignore_carry(x, big_int<H + 1, T>{1});
+      ax = subtract_ignore_carry(ax, pad<1>(a));
+    }
+    auto t = subtract_ignore_carry(big_int<N + 1, T>{}, ax);
+
+    // X = x (2^w)^L + floor(floor(t / (2^w)^L) x / (2^w)^(2 H - L))
+    auto u = skip<2 * H - L>(mul(skip<L>(t), x));
+    return add_ignore_carry(limbwise_shift_left<N + 1>(x, L), to_length<N + 1>(u));
+  }
+}
+
+} // end of detail namespace
+
+template <size_t M, typename T> constexpr
 DivisionResult<big_int<M, T>,big_int<1, T>>
 short_div(big_int<M, T> u, T v) {
-  using TT = typename dbl_bitlen<T>::type;
-  TT r{0};
+  // division by a single limb, via the reciprocal of the normalized divisor
+  constexpr auto w = std::numeric_limits<T>::digits;
+  const auto k = std::countl_zero(v);
+  const T d = static_cast<T>(v << k);
+  const T rec = detail::reciprocal_word(d);
+
+  // the limbs of u are shifted left by k bits on the fly
+  T r = k ? static_cast<T>(u[M - 1] >> (w - k)) : T{0};
   big_int<M, T> q{};
   for (int i = M - 1; i >= 0; --i) {
-    TT w = (r << std::numeric_limits<T>::digits) + u[i];
-    q[i] = w / v;
-    r = w % v;
+    T limb = static_cast<T>(u[i] << k);
+    if (k && i > 0)
+      limb |= static_cast<T>(u[i - 1] >> (w - k));
+    q[i] = detail::div_2by1(r, limb, d, rec, r);
   }
-  return {q, {static_cast<T>(r)}};
+  return {q, {static_cast<T>(r >> k)}};
 }
 
 template <size_t M, size_t N, typename T>
@@ -48,6 +231,10 @@ constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u,
   // Knuth's "Algorithm D" for multiprecision division as described in TAOCP
   // Volume 2: Seminumerical Algorithms
   // combined with short division
+  //
+  // The quotient limbs are estimated with the 3-by-2 division of Möller and
+  // Granlund (from the top three limbs of the partial remainder and the top
+  // two limbs of the divisor), which is exact, or one too large.
 
   //
   // input:
@@ -61,7 +248,6 @@ constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u,
   // returns:
   // std::pair<big_int<N+M>, big_int<N>>(quotient, rem)
 
-  using TT = typename dbl_bitlen<T>::type;
   size_t tight_N = N;
   while (tight_N > 0 && v[tight_N - 1] == 0)
     --tight_N;
@@ -69,60 +255,167 @@ constexpr DivisionResult<big_int<M, T>, big_int<N, T>> div(big_int<M, T> u,
   if (tight_N == 0)
     return {}; // division by zero
 
-  big_int<M, T> q{};
-
   if (tight_N == 1) { // short division
-    TT r {};
-    for (int i = M - 1; i >= 0; --i) {
-      TT w = (r << std::numeric_limits<T>::digits) + u[i];
-      q[i] = w / v[0];
-      r = w % v[0];
-    }
-    return {q, {static_cast<T>(r)}};
+    auto qr = short_div(u, v[0]);
+    return {qr.quotient, {qr.remainder[0]}};
   }
 
-  uint8_t k = 0;
-  while (v[tight_N - 1] <
-         (static_cast<T>(1) << (std::numeric_limits<T>::digits - 1))) {
-    ++k;
-    v = detail::first<N>(shift_left(v, 1));
-  }
+  big_int<M, T> q{};
+
+  // normalization: the most-significant bit of the divisor is set
+  const auto k = std::countl_zero(v[tight_N - 1]);
+  v = detail::first<N>(shift_left(v, k));
   auto us = shift_left(u, k);
 
-  for (int j = M - tight_N; j >= 0; --j) {
-    TT tmp = us[j + tight_N - 1];
-    TT tmp2 = us[j + tight_N];
-    tmp += (tmp2 << std::numeric_limits<T>::digits);
-    TT qhat = tmp / v[tight_N - 1];
-    TT rhat = tmp % v[tight_N - 1];
-
-    auto b = static_cast<TT>(1) << std::numeric_limits<T>::digits;
-    while (qhat == b ||
-           (qhat * v[tight_N - 2] >
-            (rhat << std::numeric_limits<T>::digits) + us[j + tight_N - 2])) {
-      qhat -= 1;
-      rhat += v[tight_N - 1];
-      if (rhat >= b)
-        break;
-    }
-    auto true_value = subtract(detail::take<N + 1>(us, j, j + tight_N + 1),
-                               mul(v, big_int<1, T>{{static_cast<T>(qhat)}}));
-    if (true_value[tight_N]) {
-      auto corrected =
-          add_ignore_carry(true_value, detail::unary_encoding<N + 2, T>(tight_N + 1));
-      auto new_us_part = add_ignore_carry(corrected, detail::pad<2>(v));
-      for (size_t i = 0; i <= tight_N; ++i)
-        us[j + i] = new_us_part[i];
-      --qhat;
+  const T d1 = v[tight_N - 1];
+  const T d0 = v[tight_N - 2];
+  const T rec = detail::reciprocal_3by2(d1, d0);
+
+  for (int j = static_cast<int>(M) - static_cast<int>(tight_N); j >= 0; --j) {
+    T u2 = us[j + tight_N];
+    T u1 = us[j + tight_N - 1];
+    T u0 = us[j + tight_N - 2];
+    T qhat;
+
+    if (u2 == d1 && u1 == d0) {
+      // the quotient limb is B - 1 (and the estimate below does not apply)
+      qhat = static_cast<T>(~T{0});
+      us[j + tight_N] -= detail::submul_row(&us[j], v.data(), tight_N, qhat);
     } else {
-      for (size_t i = 0; i <= tight_N; ++i)
-        us[j + i] = true_value[i];
+      T r1, r0;
+      qhat = detail::div_3by2(u2, u1, u0, d1, d0, rec, r1, r0);
+
+      // subtract qhat times the remaining limbs of v; if the result is
+      // negative, qhat was one too large
+      T cy = detail::submul_row(&us[j], v.data(), tight_N - 2, qhat);
+      T borrow{};
+      us[j + tight_N - 2] = detail::sub_borrow(r0, cy, T{0}, borrow);
+      us[j + tight_N - 1] = detail::sub_borrow(r1, T{0}, borrow, borrow);
+      us[j + tight_N] = 0;
+
+      if (borrow) { // unlikely
+        --qhat;
+        T carry{};
+        for (size_t i = 0; i < tight_N; ++i)
+          us[j + i] = detail::add_carry(us[j + i], v[i], carry, carry);
+      }
     }
     q[j] = qhat;
   }
   return {q, shift_right(detail::first<N>(us), k) };
 }
 
+template <size_t N, typename T>
+constexpr DivisionResult<big_int<N + 1, T>, big_int<N, T>>
+reciprocal(big_int<N, T> m) {
+  // floor((2^w)^(2 N) / m) and (2^w)^(2 N) mod m, for an m whose
+  // most-significant limb is nonzero, i.e., Barrett's mu and R^2 mod m
+  // (with R = (2^w)^N). If the most-significant limb of m is zero, the
+  // remainder is still exact, but the quotient (which then does not fit) is
+  // truncated to N + 1 limbs.
+  if constexpr (N >= CBN_NEWTON_RECIPROCAL_THRESHOLD) {
+    // with m' = m 2^k normalized, and X = approx_reciprocal(m'),
+    //   (2^w)^(2 N) / m = 2^k X + 2^k r / m',
+    // where r = (2^w)^(2 N) - X m' < 3 m' (so the division of 2^k r by m'
+    // only has a short quotient)
+    if (m[N - 1] != 0) {
+      const auto k = std::countl_zero(m[N - 1]);
+      const auto mn = detail::first<N>(shift_left(m, k));
+      const auto x = detail::approx_reciprocal(mn);
+      auto r = subtract_ignore_carry(big_int<N + 1, T>{}, partial_mul<N + 1>(x, mn));
+      auto qr = div(shift_left(r, k), mn);
+      auto mu = add_ignore_carry(detail::first<N + 1>(shift_left(x, k)),
+                                 detail::first<N + 1>(qr.quotient));
+      return {mu, shift_right(qr.remainder, k)};
+    }
+  }
+  // long division (also for an m that cannot be normalized within N limbs,
+  // as the Newton iteration requires)
+  auto qr = div(detail::unary_encoding<2 * N, 2 * N + 1, T>(), m);
+  return {detail::first<N + 1>(qr.quotient), qr.remainder};
+}
+
+namespace detail {
+
+template <size_t K, size_t N, typename T>
+constexpr auto inverse_mod_2k(big_int<N, T> a) {
+  // a^-1 mod (2^w)^K, for odd a and K <= N, by Newton (Hensel) lifting:
+  // if a x = 1 mod (2^w)^H, then x (2 - a x) = 1 / a mod (2^w)^(2 H)
+  static_assert(K <= N);
+  if constexpr (K == 1)
+    return big_int<1, T>{inverse_mod(a[0])};
+  else {
+    constexpr auto H = (K + 1) / 2;
+    auto x = inverse_mod_2k<H>(a);
+
+    // a x = 1 + e (2^w)^H  (mod (2^w)^K), so that
+    // x (2 - a x) = x - x e (2^w)^H, where x < (2^w)^H
+    auto e = skip<H>(partial_mul<K>(first<K>(a), x));
+    auto xe = partial_mul<K - H>(x, e);
+    return join(x, subtract_ignore_carry(big_int<K - H, T>{}, xe));
+  }
+}
+
+} // end of detail namespace
+
+template <size_t N, typename T>
+constexpr auto inverse_mod_2k(big_int<N, T> a) {
+  // the 2-adic inverse a^-1 mod (2^w)^N of an odd a
+  return detail::inverse_mod_2k<N>(a);
+}
+
+template <size_t M, size_t N, typename T>
+constexpr big_int<M, T> exact_div(big_int<M, T> a, big_int<N, T> d) {
+  // a / d, for a divisor d of a (otherwise, the result is meaningless)
+  //
+  // Jebelean's exact division ("An algorithm for exact division", J. Symbolic
+  // Computation, 15(2), 1993): the quotient limbs are computed from the least
+  // significant one upwards, each as the product of the current limb of the
+  // partial remainder with d^-1 mod 2^w, so that no quotient estimation (and
+  // no correction) is needed. Only the limbs of the partial remainder that
+  // determine the quotient are updated.
+
+  constexpr auto w = std::numeric_limits<T>::digits;
+
+  size_t tight_N = N;
+  while (tight_N > 0 && d[tight_N - 1] == 0)
+    --tight_N;
+
+  if (tight_N == 0)
+    return {}; // division by zero
+
+  // remove the common factor 2^z (as d divides a, the shifted-out bits of a
+  // are zero)
+  size_t z = 0;
+  while (d[z / w] == 0)
+    z += w;
+  z += std::countr_zero(d[z / w]);
+  a = shift_right(detail::skip(a, z / w), z % w);
+  d = shift_right(detail::skip(d, z / w), z % w);
+  while (tight_N > 0 && d[tight_N - 1] == 0)
+    --tight_N;
+
+  if (tight_N > M)
+    return {};
+
+  // the quotient has (at most) M - tight_N + 1 limbs
+  const auto K = M - tight_N + 1;
+  const T dinv = detail::inverse_mod(d[0]);
+
+  big_int<M, T> q{};
+  for (size_t i = 0; i < K; ++i) {
+    q[i] = static_cast<T>(a[i] * dinv);
+    auto len = std::min(tight_N, K - i);
+    auto borrow = detail::submul_row(&a[i], d.data(), len, q[i]);
+    for (auto j = i + len; j < K && borrow; ++j) {
+      T limb = a[j];
+      a[j] = static_cast<T>(limb - borrow);
+      borrow = (limb < borrow);
+    }
+  }
+  return q;
+}
+
 template <typename T, size_t N1, size_t N2>
 constexpr auto operator/(big_int<N1, T> a, big_int<N2, T> b) {
   return div(a, b).quotient;
@@ -16,6 +16,7 @@
 #include <ctbignum/io.hpp>
 #include <ctbignum/mult.hpp>
 #include <ctbignum/mod_inv.hpp>
+#include <ctbignum/montgomery.hpp>
 #include <ctbignum/slicing.hpp>
 
 #include <cstddef>
@@ -123,6 +124,25 @@ constexpr auto operator*(ZqElement<T, M...> a, ZqElement<T, M...> b) {
   return a;
 }
 
+template <typename T, T... M, T... C>
+constexpr auto& operator*=(ZqElement<T, M...>& a, std::integer_sequence<T, C...> c) {
+  // multiplication by a compile-time constant
+  a = ZqElement<T, M...> { mod(mul(a.data, c), std::integer_sequence<T, M...>()), skip_reduction{} };
+  return a;
+}
+
+template <typename T, T... M, T... C>
+constexpr auto operator*(ZqElement<T, M...> a, std::integer_sequence<T, C...> c) {
+  a *= c;
+  return a;
+}
+
+template <typename T, T... M, T... C>
+constexpr auto operator*(std::integer_sequence<T, C...> c, ZqElement<T, M...> a) {
+  a *= c;
+  return a;
+}
+
 template <typename T, T... M>
 constexpr auto& operator/=(ZqElement<T, M...>& a, ZqElement<T, M...> b) {
   a = ZqElement<T, M...>{
@@ -155,6 +175,170 @@ constexpr bool operator!=(ZqElement<T, M...> a, ZqElement<T, M...> b) {
   return !(a == b);
 }
 
+// Element of Z/qZ that is stored in Montgomery form, i.e., as a R mod q, where
+// R = (2^w)^n. Multiplication maps onto Montgomery multiplication; conversion
+// into and out of Montgomery form only happens in the constructors, in
+// operator<< and when casting to big_int. Requires an odd modulus.
+template <typename T, T... Modulus> struct MontgomeryZqElement {
+  using value_type = T;
+
+  static_assert(big_int<sizeof...(Modulus), T>{Modulus...}[0] & 1,
+                "Montgomery representation requires an odd modulus");
+
+  big_int<sizeof...(Modulus), T> data; // Montgomery form
+
+  explicit constexpr operator auto() const { // allow casting to big_int
+    return from_montgomery(data, std::integer_sequence<T, Modulus...>());
+  }
+
+  constexpr MontgomeryZqElement() : data() {}
+
+  constexpr MontgomeryZqElement(long x)
+      : data(to_montgomery(ZqElement<T, Modulus...>(x).data,
+                           std::integer_sequence<T, Modulus...>())) {}
+
+  template <T... Limbs>
+  constexpr MontgomeryZqElement(std::integer_sequence<T, Limbs...>) : data() {
+    // conversion of a compile-time constant happens at compile time
+    constexpr auto init = to_montgomery(
+        ZqElement<T, Modulus...>(std::integer_sequence<T, Limbs...>()).data,
+        std::integer_sequence<T, Modulus...>());
+    data = init;
+  }
+
+  template <std::size_t N>
+  constexpr MontgomeryZqElement(big_int<N, T> init)
+      // reduce init mod q if necessary, where q = Modulus
+      : data(to_montgomery(ZqElement<T, Modulus...>(init).data,
+                           std::integer_sequence<T, Modulus...>())) {}
+
+  constexpr MontgomeryZqElement(big_int<sizeof...(Modulus), T> init,
+                                skip_reduction)
+      : data(to_montgomery(init, std::integer_sequence<T, Modulus...>())) {}
+};
+
+template <typename T, T... Modulus>
+auto MontgomeryZq(std::integer_sequence<T, Modulus...>)
+{
+  return MontgomeryZqElement<T, Modulus...>{};
+}
+
+template <typename T, T... Modulus>
+constexpr auto extract_modulus(MontgomeryZqElement<T, Modulus...> a) {
+  return std::integer_sequence<T, Modulus...>{};
+}
+
+template <typename T, T... M>
+constexpr auto &operator+=(MontgomeryZqElement<T, M...> &a,
+                           MontgomeryZqElement<T, M...> b) {
+  a.data = mod_add(a.data, b.data, big_int<sizeof...(M), T>{M...});
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto operator+(MontgomeryZqElement<T, M...> a,
+                         MontgomeryZqElement<T, M...> b) {
+  a += b;
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto &operator-=(MontgomeryZqElement<T, M...> &a,
+                           MontgomeryZqElement<T, M...> b) {
+  a.data = mod_sub(a.data, b.data, big_int<sizeof...(M), T>{M...});
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto operator-(MontgomeryZqElement<T, M...> a,
+                         MontgomeryZqElement<T, M...> b) {
+  a -= b;
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto operator-(MontgomeryZqElement<T, M...> a) {
+  a.data = mod_sub(big_int<sizeof...(M), T>{}, a.data,
+                   big_int<sizeof...(M), T>{M...});
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto &operator*=(MontgomeryZqElement<T, M...> &a,
+                           MontgomeryZqElement<T, M...> b) {
+  a.data = montgomery_mul(a.data, b.data, std::integer_sequence<T, M...>());
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto operator*(MontgomeryZqElement<T, M...> a,
+                         MontgomeryZqElement<T, M...> b) {
+  a *= b;
+  return a;
+}
+
+template <typename T, T... M, T... C>
+constexpr auto &operator*=(MontgomeryZqElement<T, M...> &a,
+                           std::integer_sequence<T, C...> c) {
+  // multiplication by a compile-time constant (given in ordinary form):
+  // (a R) c = (a c) R, so the product only needs to be reduced mod q
+  a.data = mod(mul(a.data, c), std::integer_sequence<T, M...>());
+  return a;
+}
+
+template <typename T, T... M, T... C>
+constexpr auto operator*(MontgomeryZqElement<T, M...> a,
+                         std::integer_sequence<T, C...> c) {
+  a *= c;
+  return a;
+}
+
+template <typename T, T... M, T... C>
+constexpr auto operator*(std::integer_sequence<T, C...> c,
+                         MontgomeryZqElement<T, M...> a) {
+  a *= c;
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto &operator/=(MontgomeryZqElement<T, M...> &a,
+                           MontgomeryZqElement<T, M...> b) {
+  // mod_inv(b R) = b^-1 R^-1, which is brought back into Montgomery form
+  // by a Montgomery multiplication with R^3 mod q
+  using modulus = std::integer_sequence<T, M...>;
+  constexpr auto Rcube_mod_q = detail::montgomery_radix_power<3>(modulus());
+  auto inv = mod_inv(b.data, big_int<sizeof...(M), T>{M...});
+  a.data = montgomery_mul(a.data, montgomery_mul(inv, Rcube_mod_q, modulus()),
+                          modulus());
+  return a;
+}
+
+template <typename T, T... M>
+constexpr auto operator/(MontgomeryZqElement<T, M...> a,
+                         MontgomeryZqElement<T, M...> b) {
+  a /= b;
+  return a;
+}
+
+template <typename T, T... M>
+std::ostream &operator<<(std::ostream &strm,
+                         const MontgomeryZqElement<T, M...> &obj) {
+  strm << from_montgomery(obj.data, std::integer_sequence<T, M...>());
+  return strm;
+}
+
+template <typename T, T... M>
+constexpr bool operator==(MontgomeryZqElement<T, M...> a,
+                          MontgomeryZqElement<T, M...> b) {
+  return a.data == b.data;
+}
+
+template <typename T, T... M>
+constexpr bool operator!=(MontgomeryZqElement<T, M...> a,
+                          MontgomeryZqElement<T, M...> b) {
+  return !(a == b);
+}
+
 
 }
 #endif
@@ -15,7 +15,9 @@
 #include <ctbignum/config.hpp>
 #include <ctbignum/division.hpp>
 #include <ctbignum/mult.hpp>
+#include <ctbignum/pseudo_mersenne.hpp>
 #include <ctbignum/slicing.hpp>
+#include <ctbignum/solinas.hpp>
 #include <ctbignum/utility.hpp>
 
 #include <cstddef> // std::size_t
@@ -25,19 +27,24 @@
 namespace cbn {
 namespace detail {
 
+template <std::size_t N, std::size_t D, typename T>
+constexpr auto compute_m_prime(big_int<D, T> d, std::size_t ell) {
+  // m' = floor((2^w)^N (2^ell - d) / d) + 1, as an N-limb number,
+  // for 2^(ell - 1) < d <= 2^ell
+  constexpr auto w = std::numeric_limits<T>::digits;
+  auto pow2ell = place_at<D + 1, T>(static_cast<T>(1) << (ell % w), ell / w);
+  auto diff = first<D>(subtract_ignore_carry(pow2ell, pad<1>(d))); // < d
+  auto q = div(join(big_int<N, T>{}, diff), d).quotient;
+  return to_length<N>(add(q, big_int<1, T>{static_cast<T>(1)}));
+}
+
 template <std::size_t N, typename T = uint64_t, T... Divisor, std::size_t... Is>
 constexpr auto precompute_m_prime_nontight(std::integer_sequence<T, Divisor...>,
                                            std::index_sequence<Is...>) {
   constexpr auto D = sizeof...(Divisor);
   constexpr big_int<D, T> d{Divisor...};
   constexpr auto ell = bit_length(d - big_int<1, T>{1}); // TODO: should this indeed be d-1 ???
-  constexpr auto w = std::numeric_limits<T>::digits;
-  constexpr auto limb_shifts = ell / w;
-  constexpr auto bit_shifts = ell % w;
-  constexpr auto pow2ell = place_at<std::max(D, limb_shifts + 1), T>(static_cast<T>(1) << bit_shifts, limb_shifts);
-  constexpr auto pow2N = unary_encoding<N, N + 1, T>();
-  constexpr auto divrem = div(mul(pow2N, subtract(pow2ell, d)), d);
-  constexpr auto mp = to_length<N>(add(divrem.quotient, big_int<1, T>{static_cast<T>(1)}));
+  constexpr auto mp = compute_m_prime<N>(d, ell);
   return std::integer_sequence<T, mp[Is]...>{};
 }
 
@@ -48,6 +55,47 @@ constexpr auto precompute_m_prime(std::integer_sequence<T, Divisor...>) {
   return take_first(m, std::make_index_sequence<tight_length(m)>{});
 }
 
+template <typename T, std::size_t N, T... Divisor>
+CBN_ALWAYS_INLINE constexpr auto
+quotient_estimate(big_int<N, T> n, std::integer_sequence<T, Divisor...>) {
+  // Estimate q' of floor(n / d), with floor(n / d) - 1 <= q' <= floor(n / d)
+  //
+  // The upper part t1 = floor(m_prime n / (2^w)^N) of the product is computed
+  // with mul_high, which may underestimate t1 by one. This propagates into (at
+  // most) a unit error in the quotient, which is fixed up by the caller.
+
+  constexpr big_int<sizeof...(Divisor), T> d{Divisor...};
+  constexpr auto ell = bit_length(d - big_int<1, T>{1});
+  constexpr auto w = std::numeric_limits<T>::digits;
+  constexpr auto m_prime = to_big_int(precompute_m_prime<N>(std::integer_sequence<T, Divisor...>{}));
+
+  auto t1 = to_length<N>(mul_high<m_prime.size()>(m_prime, n));
+  auto q = shift_right(
+      skip<(ell - 1) / w>(add(t1, shift_right(subtract_ignore_carry(n, t1), 1))),
+      (ell - 1) % w); // n >= t1
+  return to_length<N>(q);
+}
+
+template <typename T, std::size_t N, T... Divisor>
+CBN_ALWAYS_INLINE constexpr auto
+invariant_divrem(big_int<N, T> n, std::integer_sequence<T, Divisor...>) {
+  // Quotient and remainder of n by a compile-time divisor d, with 1 < d < (2^w)^N
+
+  constexpr auto D = sizeof...(Divisor);
+  constexpr big_int<D, T> d{Divisor...};
+
+  auto q = quotient_estimate(n, std::integer_sequence<T, Divisor...>{});
+
+  // r = n - q d < 2 d, so D + 1 limbs suffice
+  auto r = subtract_ignore_carry(to_length<D + 1>(n), partial_mul<D + 1>(d, q));
+  auto reduced = subtract(r, d);
+  T r_geq_d = reduced[D + 1] ? 0 : 1;
+  r = r_geq_d ? first<D + 1>(reduced) : r;
+  q = add_ignore_carry(q, big_int<N, T>{r_geq_d});
+
+  return DivisionResult<big_int<N, T>, big_int<D, T>>{q, first<D>(r)};
+}
+
 } // end of detail namespace
 
 template <typename T, std::size_t N, T... Divisor>
@@ -63,28 +111,13 @@ quotient(big_int<N, T> n, std::integer_sequence<T, Divisor...>) {
   //  Divisor...  compile-time divisor
   //
 
-  using detail::to_length;
-  using detail::skip;
-
   constexpr big_int<sizeof...(Divisor), T> d{Divisor...};
   if constexpr (sizeof...(Divisor) > N) 
     return big_int<1,T>{static_cast<T>(0)};
   else if constexpr (d == big_int<1,T>{static_cast<T>(1)})
     return n;
-  else {
-    // Compile-time precomputation of m_prime
-    constexpr auto ell = detail::bit_length(d - big_int<1, T>{1});
-    constexpr auto w = std::numeric_limits<T>::digits;
-    constexpr auto m_prime = to_big_int(detail::precompute_m_prime<N>(std::integer_sequence<T, Divisor...>{}));
-    // end of pre-computation
-  
-    // Perform the division
-    auto t1 = skip<N>(mul(m_prime, n));
-    auto q = shift_right(
-        skip<(ell - 1) / w>(add(t1, shift_right(subtract_ignore_carry(n, to_length<N>(t1)), 1))),
-        (ell - 1) % w); // n >= t1
-    return to_length<N>(q);
-  }
+  else
+    return detail::invariant_divrem(n, std::integer_sequence<T, Divisor...>{}).quotient;
 }
 
 template <typename T, std::size_t N, T... Modulus>
@@ -92,9 +125,18 @@ CBN_ALWAYS_INLINE constexpr auto mod(big_int<N, T> n,
                                      std::integer_sequence<T, Modulus...>)
 // Constant-time modulo operation with a fixed modulus
 {
-  auto d = quotient(n, std::integer_sequence<T, Modulus...>{});
   constexpr auto M = sizeof...(Modulus);
-  return detail::to_length<M>(subtract_ignore_carry(n, partial_mul<N>(big_int<M, T>{Modulus...}, d)));
+  constexpr big_int<M, T> modulus{Modulus...};
+  if constexpr (M > N)
+    return detail::to_length<M>(n);
+  else if constexpr (modulus == big_int<1, T>{static_cast<T>(1)})
+    return big_int<M, T>{};
+  else if constexpr (detail::is_pseudo_mersenne(std::integer_sequence<T, Modulus...>{}))
+    return pseudo_mersenne_reduction(n, std::integer_sequence<T, Modulus...>{});
+  else if constexpr (detail::is_generalized_mersenne<T, N>(std::integer_sequence<T, Modulus...>{}))
+    return solinas_reduction(n, std::integer_sequence<T, Modulus...>{});
+  else
+    return detail::invariant_divrem(n, std::integer_sequence<T, Modulus...>{}).remainder;
 }
 
 template <typename T, std::size_t N, T... Modulus>
@@ -102,12 +144,131 @@ CBN_ALWAYS_INLINE constexpr DivisionResult<big_int<N, T>,
                                            big_int<sizeof...(Modulus), T>>
 div(big_int<N, T> n, std::integer_sequence<T, Modulus...>)
 {
-  auto quot = quotient(n, std::integer_sequence<T, Modulus...>{});
   constexpr auto M = sizeof...(Modulus);
-  auto rem = detail::to_length<M>(subtract_ignore_carry(
-      n, partial_mul<N>(big_int<M, T>{Modulus...}, quot)));
+  constexpr big_int<M, T> modulus{Modulus...};
+  if constexpr (M > N)
+    return {big_int<N, T>{}, detail::to_length<M>(n)};
+  else if constexpr (modulus == big_int<1, T>{static_cast<T>(1)})
+    return {n, big_int<M, T>{}};
+  else
+    return detail::invariant_divrem(n, std::integer_sequence<T, Modulus...>{});
+}
+
+template <std::size_t N, typename T = uint64_t, std::size_t M = 2 * N>
+struct divisor {
+  // Division by a runtime divisor d, 0 < d < (2^w)^N, of dividends of up to
+  // M limbs (by default, 2 N, e.g., products of residues), with the method of
+  // Granlund and Montgomery as above.
+  //
+  // The constants that depend on the divisor,
+  //  ell      = ceil(log2(d))
+  //  m_prime  = floor((2^w)^M (2^ell - d) / d) + 1   (M limbs)
+  // are computed once, at construction. Thereafter, a division takes the upper
+  // half of one product, a short product and a few shifts, and does not
+  // branch on the dividend.
+  // Shorter dividends are zero-extended to M limbs.
+
+  big_int<N, T> value;
+  std::size_t ell;
+  big_int<M, T> m_prime;
+
+  constexpr explicit divisor(big_int<N, T> d)
+      : value(d),
+        ell(d == big_int<1, T>{static_cast<T>(1)}
+                ? 0
+                : detail::bit_length(subtract_ignore_carry(
+                      d, big_int<N, T>{static_cast<T>(1)}))),
+        m_prime(detail::compute_m_prime<M>(d, ell)) {}
+
+  template <std::size_t K>
+  constexpr DivisionResult<big_int<K, T>, big_int<N, T>>
+  divrem(big_int<K, T> n) const {
+    static_assert(K <= M, "dividend is longer than the divisor supports");
+    auto qr = divrem_full(detail::to_length<M>(n));
+    return {detail::first<K>(qr.quotient), qr.remainder};
+  }
+
+  template <std::size_t K>
+  constexpr auto quotient(big_int<K, T> n) const {
+    return divrem(n).quotient;
+  }
+
+  template <std::size_t K>
+  constexpr auto remainder(big_int<K, T> n) const {
+    return divrem(n).remainder;
+  }
+
+private:
+  template <std::size_t K>
+  static constexpr big_int<K, T> shifted_right(big_int<K + 1, T> s,
+                                              std::size_t sh) {
+    // the K lower limbs of s / 2^sh, for a runtime shift sh
+    constexpr auto w = std::numeric_limits<T>::digits;
+    const auto limbs = sh / w;
+    const auto bits = sh % w;
+    big_int<K, T> q{};
+    for (auto i = 0U; i < K && i + limbs <= K; ++i) {
+      // (the upper limb is shifted in two steps, as bits may be zero)
+      auto upper = (i + limbs < K) ? static_cast<T>(static_cast<T>(s[i + limbs + 1] << 1)
+                                                    << (w - 1 - bits))
+                                   : T{0};
+      q[i] = static_cast<T>(s[i + limbs] >> bits) | upper;
+    }
+    return q;
+  }
+
+  constexpr DivisionResult<big_int<M, T>, big_int<N, T>>
+  divrem_full(big_int<M, T> n) const {
+    // q = (t1 + (n - t1) / 2^sh1) / 2^sh2, where t1 = floor(m_prime n / (2^w)^M),
+    // sh1 = min(ell, 1) and sh2 = max(ell - 1, 0) (Theorem 4.2 of the paper),
+    // i.e., q = (n + t1) / 2^ell (for d = 1, m_prime = 1 and t1 = 0).
+    // As in quotient_estimate, t1 is computed with mul_high, which may
+    // underestimate it (and hence q) by one; this is fixed up by a single
+    // (branch-free) conditional subtraction from the remainder.
+    constexpr auto w = std::numeric_limits<T>::digits;
+    if constexpr (M >= N) {
+      if (ell > w * (N - 1)) {
+        // d >= (2^w)^(N - 1), so that q only depends on the upper limbs of
+        // n + t1: q' = (n / (2^w)^(N - 1) + t1 / (2^w)^(N - 1)) / 2^(ell - w (N - 1)),
+        // where the second term is (approximately) the upper M - N + 1 limbs of
+        // m_prime n. The numerator is at most two too small, which is divided by
+        // at least two, so that q' is still exact or one too small.
+        // (the shift, 1 <= ell - w (N - 1) <= w, is done in two steps)
+        auto s = add(detail::skip<N - 1>(n), mul_high<M - N + 1>(m_prime, n));
+        auto q = shift_right(shift_right(s, 1), ell - w * (N - 1) - 1);
+        return correct_quotient(n, detail::to_length<M>(detail::first<M - N + 1>(q)));
+      }
+    }
+    return correct_quotient(n, shifted_right<M>(add(n, mul_high<M>(m_prime, n)), ell));
+  }
+
+  constexpr DivisionResult<big_int<M, T>, big_int<N, T>>
+  correct_quotient(big_int<M, T> n, big_int<M, T> q) const {
+    // q is exact or one too small, so that r = n - q d < 2 d fits in N + 1 limbs
+    auto r = subtract_ignore_carry(detail::to_length<N + 1>(n),
+                                   partial_mul<N + 1>(value, detail::to_length<N + 1>(q)));
+    auto reduced = subtract(r, value);
+    T r_geq_d = reduced[N + 1] ? 0 : 1;
+    r = r_geq_d ? detail::first<N + 1>(reduced) : r;
+    q = add_ignore_carry(q, big_int<M, T>{r_geq_d});
+    return {q, detail::first<N>(r)};
+  }
+};
+
+template <typename T, std::size_t K, std::size_t N, std::size_t M>
+constexpr auto quotient(big_int<K, T> n, const divisor<N, T, M> &d) {
+  // Integer division by a runtime invariant divisor
+  return d.quotient(n);
+}
+
+template <typename T, std::size_t K, std::size_t N, std::size_t M>
+constexpr auto mod(big_int<K, T> n, const divisor<N, T, M> &d) {
+  return d.remainder(n);
+}
 
-  return {quot, rem};
+template <typename T, std::size_t K, std::size_t N, std::size_t M>
+constexpr auto div(big_int<K, T> n, const divisor<N, T, M> &d) {
+  return d.divrem(n);
 }
 
 } // end of cbn namespace
@@ -15,6 +15,7 @@
 #include <ctbignum/bitshift.hpp>
 #include <ctbignum/division.hpp>
 #include <ctbignum/montgomery.hpp>
+#include <ctbignum/montgomery_context.hpp>
 #include <ctbignum/slicing.hpp>
 
 #include <cstddef>
@@ -29,8 +30,8 @@ constexpr auto mod_exp(big_int<N1, T> a, big_int<N2, T> exp,
 
   constexpr auto N = modulus.size();
   constexpr big_int<N, T> m{Modulus...};
-  constexpr auto R_mod_m = div(detail::unary_encoding<N, N + 1>(), m).remainder;
-  constexpr auto Rsq_mod_m = div(detail::unary_encoding<2 * N, 2 * N + 1>(), m).remainder;
+  constexpr auto R_mod_m = detail::montgomery_radix_power<1>(modulus);
+  constexpr auto Rsq_mod_m = detail::montgomery_radix_power<2>(modulus);
 
   auto result = R_mod_m;
   auto base = montgomery_mul(a, Rsq_mod_m, modulus);
@@ -49,7 +50,7 @@ constexpr auto mod_exp(big_int<N1, T> a, big_int<N2, T> exp,
       if (exp == zero)
         break;
     }
-    base = montgomery_mul(base, base, modulus);
+    base = montgomery_sqr(base, modulus);
   }
 
   return montgomery_mul(result, big_int<N, T>{1}, modulus);
@@ -57,36 +58,36 @@ constexpr auto mod_exp(big_int<N1, T> a, big_int<N2, T> exp,
 
 template <std::size_t N1, std::size_t N2, std::size_t N, typename T>
 constexpr auto mod_exp(big_int<N1, T> a, big_int<N2, T> exp,
-                       big_int<N, T> m) {
-
-  // modular exponentiation using Montgomery multiplication with runtime modulus
+                       const montgomery_context<N, T> &ctx) {
 
-  auto R_mod_m = div(detail::unary_encoding<N, N + 1, T>(), m).remainder;
-  auto Rsq_mod_m = div(detail::unary_encoding<2 * N, 2 * N + 1, T>(), m).remainder;
-
-  T mprime = -detail::inverse_mod(m[0]);
-
-  auto result = R_mod_m;
-  auto base = montgomery_mul(a, Rsq_mod_m, m, mprime);
+  // modular exponentiation using Montgomery multiplication with runtime
+  // modulus, reusing the precomputed constants in ctx
 
   big_int<N2, T> zero{};
   if (exp == zero)
     return big_int<N, T>{1};
-  if (m == big_int<N, T>{1})
+  if (ctx.modulus == big_int<N, T>{1})
     return big_int<N, T>{0};
 
-  while (true) {
-    auto lsb = exp[0] & 1;
-    exp = shift_right(exp, 1);
-    if (lsb) {
-      result = montgomery_mul(base, result, m, mprime);
-      if (exp == zero)
-        break;
-    }
-    base = montgomery_mul(base, base, m, mprime);
-  }
+  big_int<N, T> base{};
+  if constexpr (N1 <= N)
+    base = detail::pad<N - N1>(a);
+  else
+    base = div(a, ctx.modulus).remainder;
+
+  return ctx.from_montgomery(ctx.exp(ctx.to_montgomery(base), exp));
+}
+
+template <std::size_t N1, std::size_t N2, std::size_t N, typename T>
+constexpr auto mod_exp(big_int<N1, T> a, big_int<N2, T> exp,
+                       big_int<N, T> m) {
+
+  // modular exponentiation using Montgomery multiplication with runtime modulus
+  //
+  // note: when exponentiating repeatedly with the same modulus, construct a
+  // montgomery_context once and use the overload above
 
-  return montgomery_mul(result, big_int<N, T>{1}, m, mprime);
+  return mod_exp(a, exp, montgomery_context<N, T>(m));
 }
 
 }
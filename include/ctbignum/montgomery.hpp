@@ -12,60 +12,60 @@
 #define CT_MONTGOMERY_HPP
 
 #include <ctbignum/addition.hpp>
+#include <ctbignum/adx.hpp>
 #include <ctbignum/config.hpp>
+#include <ctbignum/division.hpp>
 #include <ctbignum/gcd.hpp>
 #include <ctbignum/mult.hpp>
 #include <ctbignum/relational_ops.hpp>
 #include <ctbignum/slicing.hpp>
 #include <ctbignum/type_traits.hpp>
 
+#include <array>
 #include <cstddef> // std::size_t
 #include <limits>
+#include <type_traits>
 
 namespace cbn {
 
-template <typename T, std::size_t N1, T... Modulus,
-          std::size_t N2 = sizeof...(Modulus)>
-constexpr auto montgomery_reduction(big_int<N1, T> A,
-                                    std::integer_sequence<T, Modulus...>) {
-  // Montgomery reduction with compile-time modulus
-  //
-  // inputs:
-  //  A       (2n limbs)  number to be reduced
-  //  m       ( n limbs)  modulus
-  //
-  // output:
-  //  T R^-1 mod m,       where R = (2^64)^n
+namespace detail {
+template <typename T, std::size_t N>
+constexpr auto lazy_carry_montgomery_mul(big_int<N, T> x, big_int<N, T> y,
+                                         big_int<N, T> m, T mprime) {
+  // Montgomery multiplication (separated operand scanning) with delayed carry
+  // propagation, for limbs that are at most half as wide as the accumulator
+  // type TT (cf. lazy_carry_mul): x y R^-1 mod m
   //
+  // The product x y and the multiples u_i m are accumulated in the column
+  // accumulators lo and hi; only column i has to be normalized to obtain u_i,
+  // and the carry out of it is kept in a running carry
 
-  using detail::skip;
-  using detail::first;
-  using detail::unary_encoding;
-  using detail::pad;
-  using detail::limbwise_shift_left;
-  using std::integer_sequence;
-
-  constexpr auto m = big_int<N2, T>{Modulus...};
-  constexpr auto inv = mod_inv(integer_sequence<T, Modulus...>{},
-                               integer_sequence<T, 0, 1>{}); // m^{-1} mod 2^64
-  constexpr T mprime = -inv[0];
+  using TT = typename dbl_bitlen<T>::type;
+  std::array<TT, 2 * N> lo{}, hi{};
+  for (std::size_t j = 0; j < N; ++j)
+    lazy_carry_addmul_row(lo, hi, j, x, y[j]);
 
-  auto accum = pad<1>(A);
+  TT carry = 0;
+  for (std::size_t i = 0; i < N; ++i) {
+    T u_i = static_cast<T>(lo[i] + carry) * mprime;
+    lazy_carry_addmul_row(lo, hi, i, m, u_i); // column i becomes 0 mod 2^w
+    carry = ((lo[i] + carry) >> std::numeric_limits<T>::digits) + hi[i];
+  }
 
-  for (auto i = 0; i < N2; ++i) {
-    auto prod = short_mul(m, accum[i] * mprime);
-    auto prod2 = limbwise_shift_left<N1 + 1>(prod, i);
-    accum = add_ignore_carry(accum, prod2);
+  big_int<N + 1, T> A{};
+  for (std::size_t k = N; k < 2 * N; ++k) {
+    TT t = lo[k] + carry;
+    A[k - N] = static_cast<T>(t);
+    carry = (t >> std::numeric_limits<T>::digits) + hi[k];
   }
+  A[N] = static_cast<T>(carry);
 
-  auto result = skip<N2>(accum);
   auto padded_mod = pad<1>(m);
-  if (result >= padded_mod)
-    result = subtract_ignore_carry(result, padded_mod);
-
-  return first<N2>(result);
+  if (A >= padded_mod)
+    A = subtract_ignore_carry(A, padded_mod);
+  return first<N>(A);
 }
-
+} // end of detail namespace
 
 template <typename T, std::size_t N, T... Modulus>
 CBN_ALWAYS_INLINE
@@ -85,6 +85,19 @@ constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y,
                                integer_sequence<T, 0, 1>{}); // m^{-1} mod 2^64
   constexpr T mprime = -inv[0];
 
+  if constexpr (std::is_same_v<T, uint32_t> && N >= CBN_LAZY_CARRY_THRESHOLD)
+    return detail::lazy_carry_montgomery_mul(x, y, m, mprime);
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t>)
+    if (!std::is_constant_evaluated()) {
+      if constexpr (sizeof...(Modulus) == N && N <= detail::asm_max_limbs)
+        return detail::adx_montgomery_mul<Modulus...>(x, y, mprime);
+      else
+        return detail::adx_montgomery_mul(x, y, m, mprime);
+    }
+#endif
+
   big_int<N + 1, T> A{};
   for (std::size_t i = 0; i < N; ++i) {
     T u_i = (A[0] + x[i] * y[0]) * mprime;
@@ -117,6 +130,205 @@ constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y,
   return first<N>(A);
 }
 
+namespace detail {
+template <typename T, std::size_t L, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_redc(big_int<L, T> A, big_int<N, T> m, T mprime) {
+  // Montgomery reduction (separated operand scanning), in-place on A
+  //
+  // inputs:
+  //  A       (2n limbs)  number to be reduced, A < m R
+  //          (or 2n + 1 limbs, A < 2 m R, e.g., a sum of two products)
+  //  m       ( n limbs)  modulus
+  //  mprime  (one limb)  mprime = - m^{-1} mod 2^64
+  //
+  // output:
+  //  A R^-1 mod m,       where R = (2^64)^n
+  //
+
+  static_assert(L == 2 * N || L == 2 * N + 1);
+  using TT = typename dbl_bitlen<T>::type;
+  T top = 0; // carry out of the most-significant limb of A
+
+  for (std::size_t i = 0; i < N; ++i) {
+    T u_i = A[i] * mprime;
+    T k = addmul_row(A, i, m, u_i); // A += u_i m (2^64)^i
+    TT t = static_cast<TT>(A[i + N]) + k + top;
+    A[i + N] = t;
+    top = t >> std::numeric_limits<T>::digits;
+  }
+
+  // the result, (hi, A[N..2N-1]), is below 2 m (or 3 m, for a 2n + 1 limb
+  // input), and is reduced in place
+  auto result = subview<N, N>(A);
+  T hi = top;
+  if constexpr (L == 2 * N + 1)
+    hi += A[2 * N];
+  for (std::size_t i = 0; i < L - 2 * N + 1; ++i)
+    hi = subtract_if_not_less(result, hi, m);
+  return result.load();
+}
+
+template <typename T, std::size_t N1, std::size_t N2>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_reduce(big_int<N1, T> A, big_int<N2, T> m,
+                                 T mprime) {
+  // Montgomery reduction of an input of any length, where A < m R (the
+  // limbs of A beyond the (2n + 1)th are zero)
+  if constexpr (N1 < 2 * N2)
+    return montgomery_redc(pad<2 * N2 - N1>(A), m, mprime);
+  else if constexpr (N1 <= 2 * N2 + 1)
+    return montgomery_redc(A, m, mprime);
+  else
+    return montgomery_redc(first<2 * N2 + 1>(A), m, mprime);
+}
+
+template <typename T, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto fips_montgomery_mul(big_int<N, T> x, big_int<N, T> y,
+                                   big_int<N, T> m, T mprime) {
+  // Montgomery multiplication, finely integrated product scanning (FIPS):
+  // x y R^-1 mod m, computed column by column (the products x[j] y[i-j] and
+  // q[j] m[i-j] of a column are summed in a three-limb accumulator), so that
+  // every limb of the result is written only once
+
+  big_int<N, T> q{}; // q = x y (-m^-1) mod R
+  big_int<N + 1, T> A{};
+  T c0 = 0, c1 = 0, c2 = 0;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    for (std::size_t j = 0; j < i; ++j) {
+      accumulate_product(x[j], y[i - j], c0, c1, c2);
+      accumulate_product(q[j], m[i - j], c0, c1, c2);
+    }
+    accumulate_product(x[i], y[0], c0, c1, c2);
+    q[i] = c0 * mprime;
+    accumulate_product(q[i], m[0], c0, c1, c2); // clears c0
+    c0 = c1;
+    c1 = c2;
+    c2 = 0;
+  }
+  for (std::size_t i = N; i < 2 * N - 1; ++i) {
+    for (std::size_t j = i - N + 1; j < N; ++j) {
+      accumulate_product(x[j], y[i - j], c0, c1, c2);
+      accumulate_product(q[j], m[i - j], c0, c1, c2);
+    }
+    A[i - N] = c0;
+    c0 = c1;
+    c1 = c2;
+    c2 = 0;
+  }
+  A[N - 1] = c0;
+  A[N] = c1;
+
+  auto padded_mod = pad<1>(m);
+  if (A >= padded_mod)
+    A = subtract_ignore_carry(A, padded_mod);
+  return first<N>(A);
+}
+
+template <std::size_t K, typename T, T... Modulus>
+constexpr auto montgomery_radix_power(std::integer_sequence<T, Modulus...>) {
+  // R^K mod m, where R = (2^w)^n, w = limb width, n = limb length of m
+  constexpr auto N = sizeof...(Modulus);
+  constexpr big_int<N, T> m{Modulus...};
+  return div(unary_encoding<K * N, K * N + 1, T>(), m).remainder;
+}
+} // end of detail namespace
+
+template <typename T, std::size_t N1, T... Modulus,
+          std::size_t N2 = sizeof...(Modulus)>
+constexpr auto montgomery_reduction(big_int<N1, T> A,
+                                    std::integer_sequence<T, Modulus...>) {
+  // Montgomery reduction with compile-time modulus
+  //
+  // inputs:
+  //  A       (2n limbs)  number to be reduced
+  //  m       ( n limbs)  modulus
+  //
+  // output:
+  //  T R^-1 mod m,       where R = (2^64)^n
+  //
+
+  using std::integer_sequence;
+
+  constexpr auto m = big_int<N2, T>{Modulus...};
+  constexpr auto inv = mod_inv(integer_sequence<T, Modulus...>{},
+                               integer_sequence<T, 0, 1>{}); // m^{-1} mod 2^64
+  constexpr T mprime = -inv[0];
+
+  return detail::montgomery_reduce(A, m, mprime);
+}
+
+template <typename T, std::size_t N, T... Modulus>
+constexpr auto to_montgomery(big_int<N, T> x,
+                             std::integer_sequence<T, Modulus...> modulus) {
+  // conversion to Montgomery form: x R mod m  (requires x < R)
+  constexpr auto Rsq_mod_m = detail::montgomery_radix_power<2>(modulus);
+  return montgomery_mul(x, Rsq_mod_m, modulus);
+}
+
+template <typename T, std::size_t N, T... Modulus>
+constexpr auto from_montgomery(big_int<N, T> x,
+                               std::integer_sequence<T, Modulus...> modulus) {
+  // conversion from Montgomery form: x R^-1 mod m
+  return montgomery_mul(x, big_int<N, T>{1}, modulus);
+}
+
+template <typename T, std::size_t N, T... Modulus>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_sqr(big_int<N, T> x,
+                              std::integer_sequence<T, Modulus...>) {
+  // Montgomery squaring with compile-time modulus: x^2 R^-1 mod m
+  // (dedicated squaring followed by Montgomery reduction)
+
+  constexpr auto m = big_int<N, T>{Modulus...};
+  constexpr auto inv = mod_inv(std::integer_sequence<T, Modulus...>{},
+                               std::integer_sequence<T, 0, 1>{}); // m^{-1} mod 2^64
+  constexpr T mprime = -inv[0];
+
+  return detail::montgomery_redc(square(x), m, mprime);
+}
+
+template <typename T, std::size_t N, T... Modulus>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul_add_mul(big_int<N, T> a, big_int<N, T> b,
+                                      big_int<N, T> c, big_int<N, T> d,
+                                      std::integer_sequence<T, Modulus...>) {
+  // (a b + c d) R^-1 mod m, with a single Montgomery reduction
+  // (requires a, b, c, d < m)
+
+  constexpr auto m = big_int<N, T>{Modulus...};
+  constexpr auto inv = mod_inv(std::integer_sequence<T, Modulus...>{},
+                               std::integer_sequence<T, 0, 1>{}); // m^{-1} mod 2^64
+  constexpr T mprime = -inv[0];
+
+  return detail::montgomery_redc(mul_add_mul(a, b, c, d), m, mprime);
+}
+
+template <typename T, std::size_t N, T... Modulus>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y,
+                              std::integer_sequence<T, Modulus...> modulus,
+                              operand_scanning) {
+  return montgomery_mul(x, y, modulus);
+}
+
+template <typename T, std::size_t N, T... Modulus>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y,
+                              std::integer_sequence<T, Modulus...>,
+                              product_scanning) {
+  // Montgomery multiplication with compile-time modulus (product scanning)
+
+  constexpr auto m = big_int<N, T>{Modulus...};
+  constexpr auto inv = mod_inv(std::integer_sequence<T, Modulus...>{},
+                               std::integer_sequence<T, 0, 1>{}); // m^{-1} mod 2^64
+  constexpr T mprime = -inv[0];
+
+  return detail::fips_montgomery_mul(x, y, m, mprime);
+}
+
 namespace {
 // Define a template that can be used to prevent type deduction of a parameter.
 template <typename T> struct Identity { typedef T type; };
@@ -141,27 +353,7 @@ constexpr auto montgomery_reduction(big_int<N1, T> A, big_int<N2, T> m,
   //  T R^-1 mod m,       where R = (2^64)^n
   //
 
-  using detail::skip;
-  using detail::first;
-  using detail::unary_encoding;
-  using detail::pad;
-  using detail::limbwise_shift_left;
-
-  auto accum = pad<1>(A);
-
-  for (auto i = 0; i < N2; ++i) {
-    auto prod = short_mul(m, accum[i] * mprime);
-    auto prod2 = limbwise_shift_left<N1 + 1>(prod, i);
-    accum = add_ignore_carry(accum, prod2);
-  }
-
-  auto result = skip<N2>(accum);
-
-  auto padded_mod = pad<1>(m);
-  if (result >= padded_mod)
-    result = subtract_ignore_carry(result, padded_mod);
-
-  return first<N2>(result);
+  return detail::montgomery_reduce(A, m, mprime);
 }
 
 /// Note: the type of the last parameter is not deduced from itself, but from
@@ -173,6 +365,15 @@ constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y, big_int<N, T> m,
 
   // Montgomery multiplication with runtime parameters
 
+  if constexpr (std::is_same_v<T, uint32_t> && N >= CBN_LAZY_CARRY_THRESHOLD)
+    return detail::lazy_carry_montgomery_mul(x, y, m, mprime);
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t>)
+    if (!std::is_constant_evaluated())
+      return detail::adx_montgomery_mul(x, y, m, mprime);
+#endif
+
   using detail::skip;
   using detail::first;
   using detail::pad;
@@ -211,19 +412,247 @@ constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y, big_int<N, T> m,
   return first<N>(A);
 }
 
+template <typename T, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y, big_int<N, T> m,
+                              Identity_t<T> mprime, operand_scanning) {
+  return montgomery_mul(x, y, m, mprime);
+}
+
+template <typename T, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y, big_int<N, T> m,
+                              Identity_t<T> mprime, product_scanning) {
+  // Montgomery multiplication with runtime parameters (product scanning)
+  return detail::fips_montgomery_mul(x, y, m, mprime);
+}
+
+/// Note: the type of the last parameter is not deduced from itself, but from
+/// the other parameters instead.
+template <typename T, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_sqr(big_int<N, T> x, big_int<N, T> m,
+                              Identity_t<T> mprime) {
+  // Montgomery squaring with runtime parameters: x^2 R^-1 mod m
+  return detail::montgomery_redc(square(x), m, mprime);
+}
+
+/// Note: the type of the last parameter is not deduced from itself, but from
+/// the other parameters instead.
+template <typename T, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul_add_mul(big_int<N, T> a, big_int<N, T> b,
+                                      big_int<N, T> c, big_int<N, T> d,
+                                      big_int<N, T> m, Identity_t<T> mprime) {
+  // (a b + c d) R^-1 mod m, with a single Montgomery reduction
+  // (requires a, b, c, d < m)
+  return detail::montgomery_redc(mul_add_mul(a, b, c, d), m, mprime);
+}
+
 namespace detail {
-template <typename T> 
-CBN_ALWAYS_INLINE  
-constexpr T inverse_mod(T a) {
-  // inverse modulo 2^(limb-width) (needed for the montgomery representation)
-  T x = ((a << 1 ^ a) & 4) << 1 ^ a;
-  x += x - a * x * x;
-  if constexpr (std::numeric_limits<T>::digits >= 16) x += x - a * x * x;
-  if constexpr (std::numeric_limits<T>::digits >= 32) x += x - a * x * x;
-  if constexpr (std::numeric_limits<T>::digits >= 64) x += x - a * x * x;
+template <typename W, typename X, typename Y, typename Mod>
+CBN_ALWAYS_INLINE
+constexpr void montgomery_mul_rows(W &&out, const X &x, const Y &y,
+                                   const Mod &m,
+                                   typename limb_traits_t<W>::type mprime) {
+  // out = x y R^-1 mod m, as in montgomery_mul, but with the accumulator A
+  // in out (apart from its most-significant limb), which must not alias x or y
+
+  using T = typename limb_traits_t<W>::type;
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto N = limb_traits_t<W>::size;
+
+  for (std::size_t i = 0; i < N; ++i)
+    out[i] = 0;
+  T top = 0;
+
+  for (std::size_t i = 0; i < N; ++i) {
+    T u_i = (out[0] + x[i] * y[0]) * mprime;
+
+    // A += x[i] * y + u_i * m followed by a 1 limb-shift to the right
+    TT z = static_cast<TT>(y[0]) * static_cast<TT>(x[i]) + out[0];
+    TT z2 = static_cast<TT>(m[0]) * static_cast<TT>(u_i) + static_cast<T>(z);
+    T k = z >> std::numeric_limits<T>::digits;
+    T k2 = z2 >> std::numeric_limits<T>::digits;
+
+    for (std::size_t j = 1; j < N; ++j) {
+      TT t = static_cast<TT>(y[j]) * static_cast<TT>(x[i]) + out[j] + k;
+      TT t2 = static_cast<TT>(m[j]) * static_cast<TT>(u_i) + static_cast<T>(t) + k2;
+      out[j - 1] = static_cast<T>(t2);
+      k = t >> std::numeric_limits<T>::digits;
+      k2 = t2 >> std::numeric_limits<T>::digits;
+    }
+
+    TT tmp = static_cast<TT>(top) + k + k2;
+    out[N - 1] = static_cast<T>(tmp);
+    top = tmp >> std::numeric_limits<T>::digits;
+  }
+
+  subtract_if_not_less(out, top, m);
+}
+
+template <typename W, typename X, typename Y, typename Mod>
+CBN_ALWAYS_INLINE
+constexpr void montgomery_mul_into(W &&out, const X &x, const Y &y,
+                                   const Mod &m,
+                                   typename limb_traits_t<W>::type mprime) {
+  // montgomery_mul_rows, where an operand that refers to the same limbs as
+  // the output is copied first
+
+  using T = typename limb_traits_t<W>::type;
+  constexpr auto N = limb_traits_t<W>::size;
+  static_assert(N == limb_traits_t<X>::size && N == limb_traits_t<Y>::size &&
+                N == limb_traits_t<Mod>::size);
+
+  const T *o = &out[0];
+  if (o == &x[0]) {
+    const big_int<N, T> x_copy = load(x);
+    if (o == &y[0])
+      montgomery_mul_rows(out, x_copy, x_copy, m, mprime);
+    else
+      montgomery_mul_rows(out, x_copy, y, m, mprime);
+  } else if (o == &y[0]) {
+    const big_int<N, T> y_copy = load(y);
+    montgomery_mul_rows(out, x, y_copy, m, mprime);
+  } else
+    montgomery_mul_rows(out, x, y, m, mprime);
+}
+} // end of detail namespace
+
+// Out-parameter variants, for big_ints and views (the output may refer to
+// the same limbs as either of the operands). The product is accumulated in
+// the output, except for the delayed-carry and ADX kernels, which keep their
+// own accumulators.
+
+template <typename W, typename X, typename Y, typename T, T... Modulus>
+requires detail::writable_limb_sequence<W> && detail::limb_sequence<X> &&
+         detail::limb_sequence<Y>
+CBN_ALWAYS_INLINE
+constexpr void montgomery_mul_into(W &&out, const X &x, const Y &y,
+                                   std::integer_sequence<T, Modulus...> modulus) {
+  // out = x y R^-1 mod m, with compile-time modulus
+
+  constexpr auto N = detail::limb_traits_t<W>::size;
+  constexpr auto m = big_int<N, T>{Modulus...};
+  constexpr auto inv = mod_inv(std::integer_sequence<T, Modulus...>{},
+                               std::integer_sequence<T, 0, 1>{});
+  constexpr T mprime = -inv[0];
+
+  if constexpr (std::is_same_v<T, uint32_t> && N >= CBN_LAZY_CARRY_THRESHOLD) {
+    detail::store(out, montgomery_mul(detail::load(x), detail::load(y), modulus));
+    return;
+  }
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t>)
+    if (!std::is_constant_evaluated()) {
+      detail::store(out, montgomery_mul(detail::load(x), detail::load(y), modulus));
+      return;
+    }
+#endif
+
+  detail::montgomery_mul_into(out, x, y, m, mprime);
+}
+
+/// Note: the type of the last parameter is not deduced from itself, but from
+/// the other parameters instead.
+template <typename W, typename X, typename Y, typename Mod>
+requires detail::writable_limb_sequence<W> && detail::limb_sequence<X> &&
+         detail::limb_sequence<Y> && detail::limb_sequence<Mod>
+CBN_ALWAYS_INLINE
+constexpr void montgomery_mul_into(W &&out, const X &x, const Y &y,
+                                   const Mod &m,
+                                   typename detail::limb_traits_t<W>::type mprime) {
+  // out = x y R^-1 mod m, with runtime parameters
+
+  using T = typename detail::limb_traits_t<W>::type;
+  constexpr auto N = detail::limb_traits_t<W>::size;
+
+  if constexpr (std::is_same_v<T, uint32_t> && N >= CBN_LAZY_CARRY_THRESHOLD) {
+    detail::store(out, montgomery_mul(detail::load(x), detail::load(y),
+                                      detail::load(m), mprime));
+    return;
+  }
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t>)
+    if (!std::is_constant_evaluated()) {
+      detail::store(out, montgomery_mul(detail::load(x), detail::load(y),
+                                        detail::load(m), mprime));
+      return;
+    }
+#endif
+
+  detail::montgomery_mul_into(out, x, y, m, mprime);
+}
+
+namespace detail {
+template <std::size_t K, typename T, std::size_t N, typename... Modulus>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul_streams(std::array<big_int<N, T>, K> x,
+                                      std::array<big_int<N, T>, K> y,
+                                      Modulus... modulus) {
+  // K independent Montgomery multiplications x[s] y[s] R^-1 mod m
+  //
+  // The multiplications do not depend on each other, so that out-of-order
+  // execution overlaps consecutive ones. (Interleaving their rows explicitly,
+  // or unrolling this loop, does not improve on this: it raises the register
+  // pressure, and it is slower than the ADX and delayed-carry kernels.)
+  for (std::size_t s = 0; s < K; ++s)
+    x[s] = montgomery_mul(x[s], y[s], modulus...);
   return x;
 }
+} // end of detail namespace
+
+template <typename T, std::size_t N, T... Modulus>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul_x2(big_int<N, T> x0, big_int<N, T> y0,
+                                 big_int<N, T> x1, big_int<N, T> y1,
+                                 std::integer_sequence<T, Modulus...> modulus) {
+  // two independent Montgomery multiplications with compile-time modulus:
+  // {x0 y0 R^-1 mod m, x1 y1 R^-1 mod m}
+  return detail::montgomery_mul_streams(std::array{x0, x1}, std::array{y0, y1},
+                                        modulus);
 }
+
+template <typename T, std::size_t N, T... Modulus>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul_x4(big_int<N, T> x0, big_int<N, T> y0,
+                                 big_int<N, T> x1, big_int<N, T> y1,
+                                 big_int<N, T> x2, big_int<N, T> y2,
+                                 big_int<N, T> x3, big_int<N, T> y3,
+                                 std::integer_sequence<T, Modulus...> modulus) {
+  // four independent Montgomery multiplications with compile-time modulus
+  return detail::montgomery_mul_streams(std::array{x0, x1, x2, x3},
+                                        std::array{y0, y1, y2, y3}, modulus);
+}
+
+/// Note: the type of the last parameter is not deduced from itself, but from
+/// the other parameters instead.
+template <typename T, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul_x2(big_int<N, T> x0, big_int<N, T> y0,
+                                 big_int<N, T> x1, big_int<N, T> y1,
+                                 big_int<N, T> m, Identity_t<T> mprime) {
+  // two independent Montgomery multiplications with runtime parameters
+  return detail::montgomery_mul_streams(std::array{x0, x1}, std::array{y0, y1},
+                                        m, mprime);
+}
+
+/// Note: the type of the last parameter is not deduced from itself, but from
+/// the other parameters instead.
+template <typename T, std::size_t N>
+CBN_ALWAYS_INLINE
+constexpr auto montgomery_mul_x4(big_int<N, T> x0, big_int<N, T> y0,
+                                 big_int<N, T> x1, big_int<N, T> y1,
+                                 big_int<N, T> x2, big_int<N, T> y2,
+                                 big_int<N, T> x3, big_int<N, T> y3,
+                                 big_int<N, T> m, Identity_t<T> mprime) {
+  // four independent Montgomery multiplications with runtime parameters
+  return detail::montgomery_mul_streams(std::array{x0, x1, x2, x3},
+                                        std::array{y0, y1, y2, y3}, m, mprime);
+}
+
 }
 #endif
 
@@ -0,0 +1,167 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#ifndef CT_MONTGOMERY_CONTEXT_HPP
+#define CT_MONTGOMERY_CONTEXT_HPP
+
+#include <ctbignum/addition.hpp>
+#include <ctbignum/barrett.hpp>
+#include <ctbignum/bigint.hpp>
+#include <ctbignum/bitshift.hpp>
+#include <ctbignum/division.hpp>
+#include <ctbignum/mod_inv.hpp>
+#include <ctbignum/montgomery.hpp>
+#include <ctbignum/relational_ops.hpp>
+#include <ctbignum/slicing.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace cbn {
+
+template <std::size_t N, typename T = uint64_t> struct montgomery_context {
+  // Montgomery arithmetic modulo a runtime (odd) modulus m.
+  //
+  // The constants that depend on the modulus,
+  //  mprime     = -m^{-1} mod 2^w
+  //  R_mod_m    = R mod m,            where R = (2^w)^N
+  //  Rsq_mod_m  = R^2 mod m,
+  //  mu         = floor(R^2 / m)      (for Barrett reduction)
+  // are computed once, at construction.
+  //
+  // Any odd modulus is accepted, including one whose most-significant limb is
+  // zero. mu is then truncated to N + 1 limbs (and is not Barrett's mu for m),
+  // so that barrett_reduction(x, ctx) uses long division instead.
+  //
+  // The member functions mul, sqr, reduce and exp act on (and return)
+  // numbers in Montgomery form.
+
+  big_int<N, T> modulus;
+  T mprime;
+  big_int<N, T> R_mod_m;
+  big_int<N, T> Rsq_mod_m;
+  big_int<N + 1, T> mu;
+
+  constexpr explicit montgomery_context(big_int<N, T> m)
+      : montgomery_context(m, reciprocal(m)) {}
+
+  constexpr auto to_montgomery(big_int<N, T> x) const {
+    // x R mod m  (requires x < R)
+    return montgomery_mul(x, Rsq_mod_m, modulus, mprime);
+  }
+
+  constexpr auto from_montgomery(big_int<N, T> x) const {
+    // x R^-1 mod m
+    return montgomery_mul(x, big_int<N, T>{1}, modulus, mprime);
+  }
+
+  constexpr auto mul(big_int<N, T> x, big_int<N, T> y) const {
+    return montgomery_mul(x, y, modulus, mprime);
+  }
+
+  constexpr auto sqr(big_int<N, T> x) const {
+    return montgomery_sqr(x, modulus, mprime);
+  }
+
+  template <std::size_t N1>
+  constexpr auto reduce(big_int<N1, T> A) const {
+    // A R^-1 mod m  (requires A < m R)
+    return montgomery_reduction(A, modulus, mprime);
+  }
+
+  template <std::size_t N2>
+  constexpr auto exp(big_int<N, T> base, big_int<N2, T> exp) const {
+    // base^exp, where base and the result are in Montgomery form
+
+    auto result = R_mod_m;
+    big_int<N2, T> zero{};
+
+    while (exp != zero) {
+      auto lsb = exp[0] & 1;
+      exp = shift_right(exp, 1);
+      if (lsb)
+        result = mul(base, result);
+      if (exp == zero)
+        break;
+      base = sqr(base);
+    }
+    return result;
+  }
+
+private:
+  constexpr montgomery_context(
+      big_int<N, T> m, DivisionResult<big_int<N + 1, T>, big_int<N, T>> recip)
+      : modulus(m), mprime(-detail::inverse_mod(m[0])),
+        R_mod_m(div(detail::unary_encoding<N, N + 1, T>(), m).remainder),
+        Rsq_mod_m(recip.remainder), mu(recip.quotient) {}
+};
+
+template <typename T, std::size_t N>
+constexpr auto to_montgomery(big_int<N, T> x,
+                             const montgomery_context<N, T> &ctx) {
+  return ctx.to_montgomery(x);
+}
+
+template <typename T, std::size_t N>
+constexpr auto from_montgomery(big_int<N, T> x,
+                               const montgomery_context<N, T> &ctx) {
+  return ctx.from_montgomery(x);
+}
+
+template <typename T, std::size_t N>
+constexpr auto montgomery_mul(big_int<N, T> x, big_int<N, T> y,
+                              const montgomery_context<N, T> &ctx) {
+  return ctx.mul(x, y);
+}
+
+template <typename T, std::size_t N>
+constexpr auto montgomery_sqr(big_int<N, T> x,
+                              const montgomery_context<N, T> &ctx) {
+  return ctx.sqr(x);
+}
+
+template <typename T, std::size_t N1, std::size_t N2>
+constexpr auto montgomery_reduction(big_int<N1, T> A,
+                                    const montgomery_context<N2, T> &ctx) {
+  return ctx.reduce(A);
+}
+
+template <typename T, std::size_t N>
+constexpr auto mod_add(big_int<N, T> a, big_int<N, T> b,
+                       const montgomery_context<N, T> &ctx) {
+  return mod_add(a, b, ctx.modulus);
+}
+
+template <typename T, std::size_t N>
+constexpr auto mod_sub(big_int<N, T> a, big_int<N, T> b,
+                       const montgomery_context<N, T> &ctx) {
+  return mod_sub(a, b, ctx.modulus);
+}
+
+template <typename T, std::size_t N1, std::size_t N>
+constexpr auto barrett_reduction(big_int<N1, T> x,
+                                 const montgomery_context<N, T> &ctx) {
+  // x mod m (requires x < (2^w)^(2 N)), using the precomputed mu
+  // (Barrett reduction requires a modulus whose most-significant limb is
+  // nonzero)
+  if (ctx.modulus[N - 1] == 0)
+    return div(detail::to_length<std::max(N1, N)>(x), ctx.modulus).remainder;
+  return barrett_reduction(x, ctx.modulus, ctx.mu);
+}
+
+template <typename T, std::size_t N>
+constexpr auto mod_inv(big_int<N, T> const &x,
+                       const montgomery_context<N, T> &ctx) {
+  return mod_inv(x, ctx.modulus);
+}
+
+} // end of cbn namespace
+
+#endif
@@ -11,14 +11,22 @@
 #ifndef CT_MULT_HPP
 #define CT_MULT_HPP
 
+#include <ctbignum/addition.hpp>
+#include <ctbignum/adx.hpp>
 #include <ctbignum/bigint.hpp>
 #include <ctbignum/config.hpp>
+#include <ctbignum/ntt.hpp>
+#include <ctbignum/slicing.hpp>
 #include <ctbignum/type_traits.hpp>
+#include <ctbignum/utility.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <limits>
+#include <type_traits>
+#include <utility>
 
 namespace cbn {
 
@@ -38,9 +46,107 @@ constexpr auto short_mul(big_int<N, T> a, T b) {
   return p;
 }
 
+namespace detail {
+
+template <size_t L, size_t M, typename T,
+          typename TT = typename dbl_bitlen<T>::type>
+CBN_ALWAYS_INLINE
+constexpr void lazy_carry_addmul_row(std::array<TT, L> &lo, std::array<TT, L> &hi,
+                                     std::size_t offset, big_int<M, T> u, T v) {
+  // (hi, lo) += u v (2^w)^offset, without carry propagation: the low and high
+  // halves of the products u[i] v are added to the column accumulators lo and
+  // hi (where column k of hi has weight (2^w)^(k+1))
+  for (std::size_t i = 0; i < M; ++i) {
+    TT p = static_cast<TT>(u[i]) * static_cast<TT>(v);
+    lo[i + offset] += static_cast<T>(p);
+    hi[i + offset] += p >> std::numeric_limits<T>::digits;
+  }
+}
+
+template <size_t R, typename T, typename TT>
+CBN_ALWAYS_INLINE
+constexpr auto lazy_carry_propagate(const std::array<TT, R> &lo,
+                                    const std::array<TT, R> &hi) {
+  // the R least-significant limbs of the sum of the column accumulators
+  big_int<R, T> w{};
+  TT carry = 0;
+  for (std::size_t k = 0; k < R; ++k) {
+    TT t = lo[k] + carry;
+    w[k] = static_cast<T>(t);
+    carry = (t >> std::numeric_limits<T>::digits) + hi[k];
+  }
+  return w;
+}
+
+template <size_t ResultLength, size_t M, size_t N, typename T>
+constexpr auto lazy_carry_partial_mul(big_int<M, T> u, big_int<N, T> v) {
+  // Operand scanning with delayed carry propagation (for limbs that are at
+  // most half as wide as the accumulator type TT). Each column accumulator
+  // receives at most min(M, N) terms below 2^w, so no accumulator overflows.
+  // Only the products that contribute to the ResultLength lower limbs are
+  // computed.
+
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto R = ResultLength;
+  std::array<TT, R> lo{}, hi{};
+  for (std::size_t j = 0; j < std::min(N, R); ++j) {
+    if constexpr (M + N <= R)
+      lazy_carry_addmul_row(lo, hi, j, u, v[j]);
+    else
+      for (std::size_t i = 0; i < std::min(M, R - j); ++i) {
+        TT p = static_cast<TT>(u[i]) * static_cast<TT>(v[j]);
+        lo[i + j] += static_cast<T>(p);
+        hi[i + j] += p >> std::numeric_limits<T>::digits;
+      }
+  }
+  return lazy_carry_propagate<R, T>(lo, hi);
+}
+
+template <size_t padding_limbs = 0U, size_t M, size_t N, typename T>
+constexpr auto lazy_carry_mul(big_int<M, T> u, big_int<N, T> v) {
+  return lazy_carry_partial_mul<M + N + padding_limbs>(u, v);
+}
+
+template <size_t ResultLength, size_t N, typename T>
+constexpr auto lazy_carry_partial_square(big_int<N, T> a) {
+  // Squaring with delayed carry propagation: the cross products a[i] a[j]
+  // (i < j) are accumulated once and doubled (each column then holds fewer
+  // than N terms below 2^w), after which the squares a[i]^2 are added
+
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto R = ResultLength;
+  std::array<TT, R> lo{}, hi{};
+  for (std::size_t i = 0; i < N; ++i)
+    for (std::size_t j = i + 1; j < N && i + j < R; ++j) {
+      TT p = static_cast<TT>(a[i]) * static_cast<TT>(a[j]);
+      lo[i + j] += static_cast<T>(p);
+      hi[i + j] += p >> std::numeric_limits<T>::digits;
+    }
+  for (std::size_t k = 0; k < R; ++k) {
+    lo[k] *= 2;
+    hi[k] *= 2;
+  }
+  for (std::size_t i = 0; i < N && 2 * i < R; ++i) {
+    TT sq = static_cast<TT>(a[i]) * static_cast<TT>(a[i]);
+    lo[2 * i] += static_cast<T>(sq);
+    hi[2 * i] += sq >> std::numeric_limits<T>::digits;
+  }
+  return lazy_carry_propagate<R, T>(lo, hi);
+}
+
 template <size_t padding_limbs = 0U, size_t M, size_t N, typename T>
 CBN_ALWAYS_INLINE 
-constexpr auto mul(big_int<M, T> u, big_int<N, T> v) {
+constexpr auto schoolbook_mul(big_int<M, T> u, big_int<N, T> v) {
+
+  if constexpr (std::is_same_v<T, uint32_t> &&
+                std::min(M, N) >= CBN_LAZY_CARRY_THRESHOLD)
+    return lazy_carry_mul<padding_limbs>(u, v);
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t>)
+    if (!std::is_constant_evaluated())
+      return adx_mul<padding_limbs>(u, v);
+#endif
 
   using TT = typename dbl_bitlen<T>::type;
   big_int<M + N + padding_limbs, T> w{};
@@ -61,11 +167,22 @@ constexpr auto mul(big_int<M, T> u, big_int<N, T> v) {
 }
 
 template <size_t ResultLength, size_t M, size_t N, typename T>
-constexpr auto partial_mul(big_int<M, T> u, big_int<N, T> v) {
+CBN_ALWAYS_INLINE
+constexpr auto schoolbook_partial_mul(big_int<M, T> u, big_int<N, T> v) {
+
+  if constexpr (std::is_same_v<T, uint32_t> &&
+                std::min(M, N) >= CBN_LAZY_CARRY_THRESHOLD)
+    return lazy_carry_partial_mul<ResultLength>(u, v);
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t>)
+    if (!std::is_constant_evaluated())
+      return adx_partial_mul<ResultLength>(u, v);
+#endif
 
   using TT = typename dbl_bitlen<T>::type;
   big_int<ResultLength, T> w{};
-  for (auto j = 0U; j < N; ++j) {
+  for (auto j = 0U; j < std::min(N, ResultLength); ++j) {
     // if (v[j] == 0) {
     //  if (j + M < ResultLength)
     //    w[j + M] = static_cast<T>(0);
@@ -84,6 +201,824 @@ constexpr auto partial_mul(big_int<M, T> u, big_int<N, T> v) {
   return w;
 }
 
+template <typename T>
+CBN_ALWAYS_INLINE
+constexpr void accumulate_product(T a, T b, T &c0, T &c1, T &c2) {
+  // (c2, c1, c0) += a * b
+  using TT = typename dbl_bitlen<T>::type;
+  TT p = static_cast<TT>(a) * static_cast<TT>(b);
+  TT s = ((static_cast<TT>(c1) << std::numeric_limits<T>::digits) | c0) + p;
+  c2 += (s < p);
+  c0 = static_cast<T>(s);
+  c1 = s >> std::numeric_limits<T>::digits;
+}
+
+template <size_t ResultLength, size_t M, size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto comba_mul(big_int<M, T> u, big_int<N, T> v) {
+  // Product scanning (Comba): the result limbs are computed one column at a
+  // time, using a three-limb accumulator, so that every limb of the result is
+  // written only once
+
+  big_int<ResultLength, T> w{};
+  T c0 = 0, c1 = 0, c2 = 0;
+  for (auto k = 0U; k < ResultLength; ++k) {
+    if (k < M + N - 1) {
+      const auto i_min = (k >= N) ? k - (N - 1) : 0U;
+      const auto i_max = std::min<size_t>(k, M - 1);
+      for (auto i = i_min; i <= i_max; ++i)
+        accumulate_product(u[i], v[k - i], c0, c1, c2);
+    }
+    w[k] = c0;
+    c0 = c1;
+    c1 = c2;
+    c2 = 0;
+  }
+  return w;
+}
+
+template <typename T>
+inline constexpr std::size_t karatsuba_threshold =
+    std::is_same_v<T, uint32_t> ? CBN_LAZY_CARRY_KARATSUBA_THRESHOLD
+                                : CBN_KARATSUBA_THRESHOLD;
+
+template <size_t Offset, size_t L, size_t K, typename T>
+constexpr void add_into(big_int<L, T> &w, big_int<K, T> x) {
+  // w += x * (2^64)^Offset, modulo (2^64)^L
+  T carry{};
+  for (auto i = Offset; i < L; ++i) {
+    T aa = w[i];
+    T sum = aa + ((i - Offset < K) ? x[i - Offset] : T{});
+    T res = sum + carry;
+    carry = (sum < aa) | (res < sum);
+    w[i] = res;
+  }
+}
+
+template <size_t M, size_t N, typename T>
+constexpr big_int<M + N, T> karatsuba_mul(big_int<M, T> u, big_int<N, T> v) {
+  // Karatsuba multiplication, for operands of (possibly) unequal lengths,
+  // with schoolbook multiplication as the base case
+  if constexpr (M < N)
+    return karatsuba_mul(v, u);
+  else if constexpr (N < karatsuba_threshold<T>)
+    return schoolbook_mul(u, v);
+  else if constexpr (2 * N <= M + 1) {
+    // unbalanced case: split u into an N-limb part and the remainder,
+    // u v = u0 v + u1 v (2^64)^N
+    auto w = pad<M - N>(karatsuba_mul(first<N>(u), v));
+    add_into<N>(w, karatsuba_mul(skip<N>(u), v));
+    return w;
+  } else {
+    // u = u1 (2^64)^h + u0, v = v1 (2^64)^h + v0,
+    // u v = z2 (2^64)^2h + (z1 - z2 - z0) (2^64)^h + z0,  where
+    // z0 = u0 v0,  z2 = u1 v1,  z1 = (u0 + u1)(v0 + v1)
+    constexpr auto h = (M + 1) / 2; // h < N <= M
+    auto u0 = first<h>(u);
+    auto v0 = first<h>(v);
+    auto u1 = skip<h>(u);
+    auto v1 = skip<h>(v);
+
+    auto z0 = karatsuba_mul(u0, v0);
+    auto z2 = karatsuba_mul(u1, v1);
+    auto z1 = karatsuba_mul(add(u0, u1), add(v0, v1));
+
+    z1 = subtract_ignore_carry(z1, pad<2>(z0));
+    z1 = subtract_ignore_carry(z1, pad<2 * h + 2 - (M + N - 2 * h)>(z2));
+
+    auto w = join(z0, z2);
+    add_into<h>(w, z1);
+    return w;
+  }
+}
+
+template <size_t ResultLength, size_t M, size_t N, typename T>
+constexpr big_int<ResultLength, T> karatsuba_mul_low(big_int<M, T> u,
+                                                     big_int<N, T> v) {
+  // the ResultLength least-significant limbs of u v, via Karatsuba
+  // multiplication of the lower halves and two recursive truncated products
+  // for the cross terms
+  constexpr auto R = ResultLength;
+  if constexpr (M > R)
+    return karatsuba_mul_low<R>(first<R>(u), v);
+  else if constexpr (N > R)
+    return karatsuba_mul_low<R>(u, first<R>(v));
+  else if constexpr (std::min(M, N) < karatsuba_threshold<T>)
+    return schoolbook_partial_mul<R>(u, v);
+  else if constexpr (M + N <= R)
+    return pad<R - M - N>(karatsuba_mul(u, v));
+  else {
+    constexpr auto h = (R + 1) / 2;
+    if constexpr (M <= h || N <= h)
+      return first<R>(karatsuba_mul(u, v));
+    else {
+      // u v mod (2^64)^R = u0 v0 + (u1 v0 + u0 v1) (2^64)^h mod (2^64)^R
+      auto w = first<R>(karatsuba_mul(first<h>(u), first<h>(v)));
+      add_into<h>(w, karatsuba_mul_low<R - h>(skip<h>(u), first<h>(v)));
+      add_into<h>(w, karatsuba_mul_low<R - h>(first<h>(u), skip<h>(v)));
+      return w;
+    }
+  }
+}
+
+template <size_t ResultLength, size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto schoolbook_partial_square(big_int<N, T> a) {
+  // the ResultLength least-significant limbs of a^2
+  //
+  // the cross products a[i] a[j] (i < j) are computed only once and then
+  // doubled, after which the squares of the individual limbs are added
+
+  if constexpr (std::is_same_v<T, uint32_t> && N >= CBN_LAZY_CARRY_THRESHOLD)
+    return lazy_carry_partial_square<ResultLength>(a);
+
+  using TT = typename dbl_bitlen<T>::type;
+  constexpr auto R = ResultLength;
+  big_int<R, T> w{};
+
+  for (auto i = 0U; i < N; ++i) {
+    T k = 0U;
+    for (auto j = i + 1; j < N && i + j < R; ++j) {
+      TT t = static_cast<TT>(a[i]) * static_cast<TT>(a[j]) + w[i + j] + k;
+      w[i + j] = static_cast<T>(t);
+      k = t >> std::numeric_limits<T>::digits;
+    }
+    if (i + N < R)
+      w[i + N] = k;
+  }
+
+  T top = 0U;
+  for (auto i = 0U; i < R; ++i) {
+    T limb = w[i];
+    w[i] = (limb << 1) | top;
+    top = limb >> (std::numeric_limits<T>::digits - 1);
+  }
+
+  T k = 0U;
+  for (auto i = 0U; i < N && 2 * i < R; ++i) {
+    TT sq = static_cast<TT>(a[i]) * static_cast<TT>(a[i]);
+    TT t = static_cast<TT>(w[2 * i]) + static_cast<T>(sq) + k;
+    w[2 * i] = static_cast<T>(t);
+    k = t >> std::numeric_limits<T>::digits;
+    if (2 * i + 1 < R) {
+      t = static_cast<TT>(w[2 * i + 1]) + (sq >> std::numeric_limits<T>::digits) + k;
+      w[2 * i + 1] = static_cast<T>(t);
+      k = t >> std::numeric_limits<T>::digits;
+    }
+  }
+  return w;
+}
+
+template <size_t N, typename T>
+constexpr big_int<2 * N, T> karatsuba_square(big_int<N, T> a) {
+  // Karatsuba squaring: a^2 = z2 (2^64)^2h + (z1 - z2 - z0) (2^64)^h + z0,
+  // where z0 = a0^2, z2 = a1^2, z1 = (a0 + a1)^2
+  if constexpr (N < karatsuba_threshold<T>)
+    return schoolbook_partial_square<2 * N>(a);
+  else {
+    constexpr auto h = (N + 1) / 2;
+    auto a0 = first<h>(a);
+    auto a1 = skip<h>(a);
+
+    auto z0 = karatsuba_square(a0);
+    auto z2 = karatsuba_square(a1);
+    auto z1 = karatsuba_square(add(a0, a1));
+
+    z1 = subtract_ignore_carry(z1, pad<2>(z0));
+    z1 = subtract_ignore_carry(z1, pad<2 * h + 2 - (2 * N - 2 * h)>(z2));
+
+    auto w = join(z0, z2);
+    add_into<h>(w, z1);
+    return w;
+  }
+}
+
+template <size_t ResultLength, size_t N, typename T>
+constexpr big_int<ResultLength, T> karatsuba_square_low(big_int<N, T> a) {
+  // the ResultLength least-significant limbs of a^2
+  constexpr auto R = ResultLength;
+  if constexpr (N > R)
+    return karatsuba_square_low<R>(first<R>(a));
+  else if constexpr (N < karatsuba_threshold<T>)
+    return schoolbook_partial_square<R>(a);
+  else if constexpr (2 * N <= R)
+    return pad<R - 2 * N>(karatsuba_square(a));
+  else {
+    constexpr auto h = (R + 1) / 2;
+    if constexpr (N <= h)
+      return first<R>(karatsuba_square(a));
+    else {
+      // a^2 mod (2^64)^R = a0^2 + 2 a0 a1 (2^64)^h mod (2^64)^R
+      auto w = first<R>(karatsuba_square(first<h>(a)));
+      auto cross = karatsuba_mul_low<R - h>(skip<h>(a), first<h>(a));
+      add_into<h>(w, cross);
+      add_into<h>(w, cross);
+      return w;
+    }
+  }
+}
+
+template <typename T, T C, size_t J, size_t R, size_t N>
+CBN_ALWAYS_INLINE
+constexpr void addmul_constant_row(big_int<R, T> &w, big_int<N, T> u) {
+  // w += u C (2^w)^J, where C is the J-th limb of a compile-time constant.
+  // Zero limbs contribute nothing, and power-of-two limbs become shifts.
+
+  if constexpr (C == 0)
+    return;
+  else if constexpr ((C & (C - 1)) == 0) {
+    constexpr auto s = bit_length(big_int<1, T>{C}) - 1;
+    T hi = 0U;
+    T carry = 0U;
+    for (auto i = 0U; i < N; ++i) {
+      T lo = u[i];
+      if constexpr (s > 0) {
+        lo = (lo << s) | hi;
+        hi = u[i] >> (std::numeric_limits<T>::digits - s);
+      }
+      T sum = w[i + J] + lo;
+      T res = sum + carry;
+      carry = (sum < lo) | (res < sum);
+      w[i + J] = res;
+    }
+    w[J + N] = hi + carry;
+  } else {
+    using TT = typename dbl_bitlen<T>::type;
+    T k = 0U;
+    for (auto i = 0U; i < N; ++i) {
+      TT t = static_cast<TT>(u[i]) * static_cast<TT>(C) + w[i + J] + k;
+      w[i + J] = static_cast<T>(t);
+      k = t >> std::numeric_limits<T>::digits;
+    }
+    w[J + N] = k;
+  }
+}
+
+template <typename T, size_t N, T... C, size_t... J>
+CBN_ALWAYS_INLINE
+constexpr auto mul_constant(big_int<N, T> u, std::integer_sequence<T, C...>,
+                            std::index_sequence<J...>) {
+  // schoolbook multiplication, unrolled over the limbs of the constant
+  big_int<N + sizeof...(C), T> w{};
+  (addmul_constant_row<T, C, J>(w, u), ...);
+  return w;
+}
+
+template <typename W, typename U, typename V>
+CBN_ALWAYS_INLINE
+constexpr void mul_into(W &&w, const U &u, const V &v) {
+  // w += u v, where the limbs w[M..R-1] must be zero (so that the carry out of
+  // each row can be stored rather than added), and w must not alias u or v
+  // (each of which is a big_int or a view)
+
+  using T = typename limb_traits_t<W>::type;
+  constexpr auto R = limb_traits_t<W>::size;
+  constexpr auto M = limb_traits_t<U>::size;
+  constexpr auto N = limb_traits_t<V>::size;
+  static_assert(R >= M + N);
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t> && !limb_traits_t<W>::is_view &&
+                !limb_traits_t<U>::is_view && !limb_traits_t<V>::is_view)
+    if (!std::is_constant_evaluated()) {
+      adx_mul_into(w, u, v);
+      return;
+    }
+#endif
+
+  using TT = typename dbl_bitlen<T>::type;
+  for (auto j = 0U; j < N; ++j) {
+    T k = 0U;
+    for (auto i = 0U; i < M; ++i) {
+      TT t = static_cast<TT>(u[i]) * static_cast<TT>(v[j]) + w[i + j] + k;
+      w[i + j] = static_cast<T>(t);
+      k = t >> std::numeric_limits<T>::digits;
+    }
+    w[j + M] = k;
+  }
+}
+
+template <size_t M, size_t L, typename T>
+CBN_ALWAYS_INLINE
+constexpr T addmul_row(big_int<L, T> &w, size_t offset, big_int<M, T> u, T v) {
+  // w[offset..offset+M-1] += u v, returns the carry limb
+
+#ifdef CBN_USE_ADX
+  // (short rows are left to the portable loop, which can keep w in registers,
+  // whereas the asm row reads and writes it through memory)
+  if constexpr (std::is_same_v<T, uint64_t> && M > 4)
+    if (!std::is_constant_evaluated())
+      return adx_addmul_row<M>(&w[offset], u.data(), v);
+#endif
+
+  using TT = typename dbl_bitlen<T>::type;
+  T k = 0U;
+  for (auto i = 0U; i < M; ++i) {
+    TT t = static_cast<TT>(u[i]) * static_cast<TT>(v) + w[offset + i] + k;
+    w[offset + i] = static_cast<T>(t);
+    k = t >> std::numeric_limits<T>::digits;
+  }
+  return k;
+}
+
+template <size_t R, size_t M, size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr void addmul_into(big_int<R, T> &w, big_int<M, T> u, big_int<N, T> v) {
+  // w += u v mod (2^w)^R, row by row (the carry out of the top limb of each
+  // row is added to the next row's top limb)
+
+  static_assert(R >= M + N);
+  using TT = typename dbl_bitlen<T>::type;
+  T top = 0U;
+  for (auto j = 0U; j < N; ++j) {
+    TT t = static_cast<TT>(w[j + M]) + addmul_row(w, j, u, v[j]) + top;
+    w[j + M] = static_cast<T>(t);
+    top = t >> std::numeric_limits<T>::digits;
+  }
+  for (auto i = M + N; i < R; ++i) {
+    T t = w[i] + top;
+    top = t < top;
+    w[i] = t;
+  }
+}
+
+template <size_t K, typename U, typename V>
+CBN_ALWAYS_INLINE
+constexpr auto mul_high(const U &u, const V &v) {
+  // An approximation q of the K most-significant limbs of u v,
+  // i.e., of floor(u v / (2^w)^(M + N - K)), with q <= floor(...) <= q + 1
+  //
+  // Computes only the columns of the (product-scanning) multiplication that
+  // contribute to the K upper limbs, plus two guard columns. The products in
+  // the skipped columns sum to less than min(M, N) (2^w)^(M + N - K - 1),
+  // hence contribute at most one unit to the result.
+
+  using T = typename limb_traits_t<U>::type;
+  constexpr auto M = limb_traits_t<U>::size;
+  constexpr auto N = limb_traits_t<V>::size;
+  static_assert(K <= M + N);
+  constexpr auto L = M + N;
+  constexpr auto guard = std::size_t{2};
+  constexpr auto first_column = (L > K + guard) ? L - K - guard : std::size_t{0};
+
+  big_int<K, T> w{};
+  T c0 = 0, c1 = 0, c2 = 0;
+  for (auto k = first_column; k < L; ++k) {
+    if (k < L - 1) {
+      const auto i_min = (k >= N) ? k - (N - 1) : std::size_t{0};
+      const auto i_max = std::min<std::size_t>(k, M - 1);
+      for (auto i = i_min; i <= i_max; ++i)
+        accumulate_product(u[i], v[k - i], c0, c1, c2);
+    }
+    if (k >= L - K)
+      w[k - (L - K)] = c0;
+    c0 = c1;
+    c1 = c2;
+    c2 = 0;
+  }
+  return w;
+}
+
+// Multiplication and squaring into an output of exactly M + N (resp. 2 N)
+// limbs, for big_ints and views. The Karatsuba variants recurse on subviews of
+// the output: z0 and z2 are computed in place (in the lower and upper part),
+// and only the middle product z1 and the operand sums go to the scratch
+// buffer (of karatsuba_scratch_limbs limbs), which is shared by the recursive
+// calls. The output must not alias the operands or the scratch buffer.
+
+template <typename W, typename A>
+CBN_ALWAYS_INLINE
+constexpr void square_into(W &&w, const A &a) {
+  // w = a^2 (cf. schoolbook_partial_square)
+
+  using T = typename limb_traits_t<W>::type;
+  constexpr auto R = limb_traits_t<W>::size;
+  constexpr auto N = limb_traits_t<A>::size;
+  static_assert(R == 2 * N);
+  using TT = typename dbl_bitlen<T>::type;
+
+  for (auto i = 0U; i < R; ++i)
+    w[i] = 0;
+  for (auto i = 0U; i < N; ++i) {
+    T k = 0U;
+    for (auto j = i + 1; j < N; ++j) {
+      TT t = static_cast<TT>(a[i]) * static_cast<TT>(a[j]) + w[i + j] + k;
+      w[i + j] = static_cast<T>(t);
+      k = t >> std::numeric_limits<T>::digits;
+    }
+    w[i + N] = k;
+  }
+
+  T top = 0U;
+  for (auto i = 0U; i < R; ++i) {
+    T limb = w[i];
+    w[i] = (limb << 1) | top;
+    top = limb >> (std::numeric_limits<T>::digits - 1);
+  }
+
+  T k = 0U;
+  for (auto i = 0U; i < N; ++i) {
+    TT sq = static_cast<TT>(a[i]) * static_cast<TT>(a[i]);
+    TT t = static_cast<TT>(w[2 * i]) + static_cast<T>(sq) + k;
+    w[2 * i] = static_cast<T>(t);
+    k = t >> std::numeric_limits<T>::digits;
+    t = static_cast<TT>(w[2 * i + 1]) + (sq >> std::numeric_limits<T>::digits) + k;
+    w[2 * i + 1] = static_cast<T>(t);
+    k = t >> std::numeric_limits<T>::digits;
+  }
+}
+
+template <typename W, typename U, typename V>
+CBN_ALWAYS_INLINE
+constexpr void schoolbook_mul_into(W &&w, const U &u, const V &v) {
+  // w = u v (the base case of karatsuba_mul_into; the kernels with their own
+  // accumulators, as used by schoolbook_mul, store their result)
+
+  using T = typename limb_traits_t<W>::type;
+  constexpr auto R = limb_traits_t<W>::size;
+  constexpr auto M = limb_traits_t<U>::size;
+  constexpr auto N = limb_traits_t<V>::size;
+
+  if constexpr (std::is_same_v<T, uint32_t> &&
+                std::min(M, N) >= CBN_LAZY_CARRY_THRESHOLD) {
+    store(w, lazy_carry_partial_mul<R>(load(u), load(v)));
+    return;
+  }
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t>)
+    if (!std::is_constant_evaluated()) {
+      store(w, adx_mul<R - M - N>(load(u), load(v)));
+      return;
+    }
+#endif
+
+  for (auto i = 0U; i < R; ++i)
+    w[i] = 0;
+  detail::mul_into(w, u, v);
+}
+
+template <typename W, typename A>
+CBN_ALWAYS_INLINE
+constexpr void schoolbook_square_into(W &&w, const A &a) {
+  // w = a^2 (the base case of karatsuba_square_into)
+
+  using T = typename limb_traits_t<W>::type;
+  constexpr auto N = limb_traits_t<A>::size;
+
+  if constexpr (std::is_same_v<T, uint32_t> && N >= CBN_LAZY_CARRY_THRESHOLD) {
+    store(w, lazy_carry_partial_square<2 * N>(load(a)));
+    return;
+  }
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t> && N >= 2 && N <= asm_max_limbs)
+    if (!std::is_constant_evaluated()) {
+      store(w, adx_square(load(a)));
+      return;
+    }
+#endif
+
+  detail::square_into(w, a);
+}
+
+template <size_t M, size_t N, typename T>
+constexpr size_t karatsuba_scratch_limbs() {
+  // the scratch space of karatsuba_mul_into (cf. karatsuba_mul)
+  if constexpr (M < N)
+    return karatsuba_scratch_limbs<N, M, T>();
+  else if constexpr (N < karatsuba_threshold<T>)
+    return 0;
+  else if constexpr (2 * N <= M + 1)
+    return std::max(karatsuba_scratch_limbs<M - N, N, T>(),
+                    2 * N + karatsuba_scratch_limbs<N, N, T>());
+  else {
+    constexpr auto h = (M + 1) / 2;
+    return std::max({karatsuba_scratch_limbs<h, h, T>(),
+                     karatsuba_scratch_limbs<M - h, N - h, T>(),
+                     4 * h + 4 + karatsuba_scratch_limbs<h + 1, h + 1, T>()});
+  }
+}
+
+template <size_t N, typename T>
+constexpr size_t karatsuba_square_scratch_limbs() {
+  // the scratch space of karatsuba_square_into
+  if constexpr (N < karatsuba_threshold<T>)
+    return 0;
+  else {
+    constexpr auto h = (N + 1) / 2;
+    return std::max({karatsuba_square_scratch_limbs<h, T>(),
+                     karatsuba_square_scratch_limbs<N - h, T>(),
+                     3 * h + 3 + karatsuba_square_scratch_limbs<h + 1, T>()});
+  }
+}
+
+template <typename S, typename X0, typename X1>
+CBN_ALWAYS_INLINE
+constexpr void sum_into(S &&s, const X0 &x0, const X1 &x1) {
+  // s = x0 + x1, where s has (at least) one more limb than x0 and x1
+  constexpr auto L = limb_traits_t<S>::size;
+  constexpr auto H = limb_traits_t<X0>::size;
+  for (auto i = 0U; i < L; ++i)
+    s[i] = (i < H) ? x0[i] : 0;
+  add_to(s, x1);
+}
+
+template <typename W, typename U, typename V, typename S>
+constexpr void karatsuba_mul_into(W &&w, const U &u, const V &v, S &&scratch) {
+  // w = u v (cf. karatsuba_mul), where w has M + N limbs
+
+  using T = typename limb_traits_t<W>::type;
+  constexpr auto M = limb_traits_t<U>::size;
+  constexpr auto N = limb_traits_t<V>::size;
+  constexpr auto L = limb_traits_t<S>::size;
+  static_assert(limb_traits_t<W>::size == M + N);
+  static_assert(L >= karatsuba_scratch_limbs<M, N, T>());
+
+  if constexpr (M < N)
+    karatsuba_mul_into(w, v, u, scratch);
+  else if constexpr (N < karatsuba_threshold<T>)
+    schoolbook_mul_into(w, u, v);
+  else if constexpr (2 * N <= M + 1) {
+    // unbalanced case: u1 v goes to the upper M limbs of w, u0 v (2N limbs)
+    // to the scratch buffer, after which it is added
+    karatsuba_mul_into(subview<N, M>(w), subview<N, M - N>(u), v, scratch);
+    auto p = subview<0, 2 * N>(scratch);
+    karatsuba_mul_into(p, subview<0, N>(u), v, subview<2 * N, L - 2 * N>(scratch));
+    for (auto i = 0U; i < N; ++i)
+      w[i] = p[i];
+    add_to(subview<N, M>(w), subview<N, N>(p));
+  } else {
+    constexpr auto h = (M + 1) / 2; // h < N <= M
+    auto z0 = subview<0, 2 * h>(w);
+    auto z2 = subview<2 * h, M + N - 2 * h>(w);
+    karatsuba_mul_into(z0, subview<0, h>(u), subview<0, h>(v), scratch);
+    karatsuba_mul_into(z2, subview<h, M - h>(u), subview<h, N - h>(v), scratch);
+
+    // z1 = (u0 + u1)(v0 + v1) - z0 - z2
+    auto su = subview<0, h + 1>(scratch);
+    auto sv = subview<h + 1, h + 1>(scratch);
+    auto z1 = subview<2 * h + 2, 2 * h + 2>(scratch);
+    sum_into(su, subview<0, h>(u), subview<h, M - h>(u));
+    sum_into(sv, subview<0, h>(v), subview<h, N - h>(v));
+    karatsuba_mul_into(z1, su, sv, subview<4 * h + 4, L - 4 * h - 4>(scratch));
+    sub_from(z1, z0);
+    sub_from(z1, z2);
+
+    // (the upper limbs of z1 are zero, if w is shorter than h + 2 h + 2)
+    constexpr auto K = std::min(2 * h + 2, M + N - h);
+    add_to(subview<h, M + N - h>(w), subview<0, K>(z1));
+  }
+}
+
+template <typename W, typename A, typename S>
+constexpr void karatsuba_square_into(W &&w, const A &a, S &&scratch) {
+  // w = a^2 (cf. karatsuba_square), where w has 2 N limbs
+
+  using T = typename limb_traits_t<W>::type;
+  constexpr auto N = limb_traits_t<A>::size;
+  constexpr auto L = limb_traits_t<S>::size;
+  static_assert(limb_traits_t<W>::size == 2 * N);
+  static_assert(L >= karatsuba_square_scratch_limbs<N, T>());
+
+  if constexpr (N < karatsuba_threshold<T>)
+    schoolbook_square_into(w, a);
+  else {
+    constexpr auto h = (N + 1) / 2;
+    auto z0 = subview<0, 2 * h>(w);
+    auto z2 = subview<2 * h, 2 * N - 2 * h>(w);
+    karatsuba_square_into(z0, subview<0, h>(a), scratch);
+    karatsuba_square_into(z2, subview<h, N - h>(a), scratch);
+
+    // z1 = (a0 + a1)^2 - z0 - z2
+    auto s = subview<0, h + 1>(scratch);
+    auto z1 = subview<h + 1, 2 * h + 2>(scratch);
+    sum_into(s, subview<0, h>(a), subview<h, N - h>(a));
+    karatsuba_square_into(z1, s, subview<3 * h + 3, L - 3 * h - 3>(scratch));
+    sub_from(z1, z0);
+    sub_from(z1, z2);
+
+    constexpr auto K = std::min(2 * h + 2, 2 * N - h);
+    add_to(subview<h, 2 * N - h>(w), subview<0, K>(z1));
+  }
+}
+
+} // end of detail namespace
+
+// Policies for selecting the multiplication loop order:
+// operand scanning (the default; row by row, with Karatsuba for large
+// operands), or product scanning (column by column, Comba's method)
+struct operand_scanning {};
+struct product_scanning {};
+
+template <size_t padding_limbs = 0U, size_t M, size_t N, typename T>
+CBN_ALWAYS_INLINE 
+constexpr auto mul(big_int<M, T> u, big_int<N, T> v) {
+
+  if constexpr (std::is_same_v<T, uint64_t> &&
+                std::min(M, N) >= CBN_NTT_THRESHOLD)
+    if (!std::is_constant_evaluated())
+      return detail::pad<padding_limbs>(detail::ntt_mul(u, v));
+
+  if constexpr (std::min(M, N) >= detail::karatsuba_threshold<T>)
+    return detail::pad<padding_limbs>(detail::karatsuba_mul(u, v));
+  else
+    return detail::schoolbook_mul<padding_limbs>(u, v);
+}
+
+template <size_t padding_limbs = 0U, size_t M, size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto mul(big_int<M, T> u, big_int<N, T> v, operand_scanning) {
+  return mul<padding_limbs>(u, v);
+}
+
+template <size_t padding_limbs = 0U, size_t M, size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto mul(big_int<M, T> u, big_int<N, T> v, product_scanning) {
+  return detail::comba_mul<M + N + padding_limbs>(u, v);
+}
+
+template <size_t ResultLength, size_t M, size_t N, typename T>
+constexpr auto partial_mul(big_int<M, T> u, big_int<N, T> v) {
+
+  if constexpr (std::min(M, N) >= detail::karatsuba_threshold<T>)
+    return detail::karatsuba_mul_low<ResultLength>(u, v);
+  else
+    return detail::schoolbook_partial_mul<ResultLength>(u, v);
+}
+
+template <size_t ResultLength, size_t M, size_t N, typename T>
+constexpr auto partial_mul(big_int<M, T> u, big_int<N, T> v, operand_scanning) {
+  return partial_mul<ResultLength>(u, v);
+}
+
+template <size_t ResultLength, size_t M, size_t N, typename T>
+constexpr auto partial_mul(big_int<M, T> u, big_int<N, T> v, product_scanning) {
+  return detail::comba_mul<ResultLength>(u, v);
+}
+
+template <size_t K, size_t M, size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto mul_low(big_int<M, T> u, big_int<N, T> v) {
+  // the K least-significant limbs of u v (products that only contribute to
+  // the discarded limbs are skipped)
+  return partial_mul<K>(u, v);
+}
+
+template <size_t K, size_t M, size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto mul_high(big_int<M, T> u, big_int<N, T> v) {
+  // An approximation q of the K most-significant limbs of u v, with
+  // q <= floor(u v / (2^w)^(M + N - K)) <= q + 1
+  return detail::mul_high<K>(u, v);
+}
+
+template <size_t N, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto square(big_int<N, T> a) {
+
+#ifdef CBN_USE_ADX
+  if constexpr (std::is_same_v<T, uint64_t> && N >= 2 &&
+                N <= detail::asm_max_limbs)
+    if (!std::is_constant_evaluated())
+      return detail::adx_square(a);
+#endif
+
+  if constexpr (std::is_same_v<T, uint64_t> && N >= CBN_NTT_THRESHOLD)
+    if (!std::is_constant_evaluated())
+      return detail::ntt_mul(a, a, true);
+
+  if constexpr (N >= detail::karatsuba_threshold<T>)
+    return detail::karatsuba_square(a);
+  else
+    return detail::schoolbook_partial_square<2 * N>(a);
+}
+
+template <size_t ResultLength, size_t N, typename T>
+constexpr auto partial_square(big_int<N, T> a) {
+
+  if constexpr (N >= detail::karatsuba_threshold<T>)
+    return detail::karatsuba_square_low<ResultLength>(a);
+  else
+    return detail::schoolbook_partial_square<ResultLength>(a);
+}
+
+template <typename T, size_t N, T... C>
+CBN_ALWAYS_INLINE
+constexpr auto mul(big_int<N, T> u, std::integer_sequence<T, C...> c) {
+  // Multiplication by a compile-time constant (e.g., a _Z literal). Zero limbs
+  // of the constant are skipped, and limbs that are a power of two are
+  // applied as shifts.
+  return detail::mul_constant(u, c, std::make_index_sequence<sizeof...(C)>{});
+}
+
+template <size_t M, size_t N, size_t K, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto mul_add(big_int<M, T> u, big_int<N, T> v, big_int<K, T> c) {
+  // u v + c, where c is added into the carry chain of the multiplication
+  // (the result has M + N limbs when c has at most max(M, N) limbs, and one
+  // more limb than the longest term otherwise)
+
+  constexpr auto R = (K <= std::max(M, N)) ? M + N : std::max(M + N, K) + 1;
+  auto w = detail::to_length<R>(c);
+  if constexpr (K <= M)
+    detail::mul_into(w, u, v);
+  else if constexpr (K <= N)
+    detail::mul_into(w, v, u);
+  else
+    detail::addmul_into(w, u, v);
+  return w;
+}
+
+template <size_t M1, size_t N1, size_t M2, size_t N2, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto mul_add_mul(big_int<M1, T> a, big_int<N1, T> b,
+                           big_int<M2, T> c, big_int<N2, T> d) {
+  // a b + c d, where the rows of c d are accumulated onto a b
+
+  constexpr auto R = std::max(M1 + N1, M2 + N2) + 1;
+  auto w = mul<R - M1 - N1>(a, b);
+  detail::addmul_into(w, c, d);
+  return w;
+}
+
+template <size_t M, size_t N, size_t K, typename T>
+CBN_ALWAYS_INLINE
+constexpr auto mul_sub(big_int<M, T> u, big_int<N, T> v, big_int<K, T> c) {
+  // u v - c mod (2^w)^max(M + N, K), i.e., exact if c <= u v
+
+  constexpr auto R = std::max(M + N, K);
+  auto w = subtract_ignore_carry(big_int<R, T>{}, detail::to_length<R>(c));
+  detail::addmul_into(w, u, v);
+  return w;
+}
+
+// Out-parameter variants, which write the product into an existing big_int
+// or writable view (of at least M + N limbs; the remaining limbs are cleared)
+// and take the operands (big_ints or views) by reference, to avoid by-value
+// copies for long operands. The output must not alias the operands.
+
+template <typename W, typename U, typename V>
+requires detail::writable_limb_sequence<W> && detail::limb_sequence<U> &&
+         detail::limb_sequence<V>
+CBN_ALWAYS_INLINE
+constexpr void mul_into(W &&out, const U &u, const V &v) {
+  // out = u v
+
+  using T = typename detail::limb_traits_t<W>::type;
+  constexpr auto R = detail::limb_traits_t<W>::size;
+  constexpr auto M = detail::limb_traits_t<U>::size;
+  constexpr auto N = detail::limb_traits_t<V>::size;
+  static_assert(std::is_same_v<T, typename detail::limb_traits_t<U>::type> &&
+                std::is_same_v<T, typename detail::limb_traits_t<V>::type>);
+  static_assert(R >= M + N, "mul_into requires an output of M + N limbs");
+
+  if constexpr (std::is_same_v<T, uint64_t> &&
+                std::min(M, N) >= CBN_NTT_THRESHOLD)
+    if (!std::is_constant_evaluated()) {
+      // (the transforms need their own buffers)
+      detail::store(out, mul<R - M - N>(detail::load(u), detail::load(v)));
+      return;
+    }
+
+  if constexpr (std::min(M, N) >= detail::karatsuba_threshold<T>) {
+    // the Karatsuba recursion writes into subviews of the output, with a
+    // scratch buffer on the stack
+    big_int<detail::karatsuba_scratch_limbs<M, N, T>(), T> scratch{};
+    detail::karatsuba_mul_into(detail::subview<0, M + N>(out), u, v, scratch);
+    for (auto i = M + N; i < R; ++i)
+      out[i] = 0;
+  } else {
+    for (auto i = 0U; i < R; ++i)
+      out[i] = 0;
+    detail::mul_into(out, u, v);
+  }
+}
+
+template <typename W, typename A>
+requires detail::writable_limb_sequence<W> && detail::limb_sequence<A>
+CBN_ALWAYS_INLINE
+constexpr void square_into(W &&out, const A &a) {
+  // out = a^2
+
+  using T = typename detail::limb_traits_t<W>::type;
+  constexpr auto R = detail::limb_traits_t<W>::size;
+  constexpr auto N = detail::limb_traits_t<A>::size;
+  static_assert(std::is_same_v<T, typename detail::limb_traits_t<A>::type>);
+  static_assert(R >= 2 * N, "square_into requires an output of 2 N limbs");
+
+  if constexpr (std::is_same_v<T, uint64_t> && N >= CBN_NTT_THRESHOLD)
+    if (!std::is_constant_evaluated()) {
+      detail::store(out, detail::pad<R - 2 * N>(square(detail::load(a))));
+      return;
+    }
+
+  big_int<detail::karatsuba_square_scratch_limbs<N, T>(), T> scratch{};
+  detail::karatsuba_square_into(detail::subview<0, 2 * N>(out), a, scratch);
+  for (auto i = 2 * N; i < R; ++i)
+    out[i] = 0;
+}
+
 template <typename T, size_t N1, size_t N2>
 constexpr auto operator*(big_int<N1, T> a, big_int<N2, T> b) {
   return mul(a, b);
@@ -0,0 +1,284 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#ifndef CT_NTT_HPP
+#define CT_NTT_HPP
+
+#include <ctbignum/bigint.hpp>
+#include <ctbignum/config.hpp>
+#include <ctbignum/type_traits.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace cbn {
+namespace detail {
+
+// Multiplication via number-theoretic transforms (NTTs), for operands of
+// (many) hundreds of 64-bit limbs.
+//
+// The limbs of the operands are the coefficients of two polynomials, whose
+// product (the acyclic convolution of the limbs) is computed modulo three
+// primes of the form k 2^e + 1, below 2^62. The coefficients of the product
+// are smaller than (length) 2^128, while the product of the primes exceeds
+// 2^183, so that the coefficients can be recovered exactly by the Chinese
+// remainder theorem (Garner's algorithm), for lengths up to 2^55.
+//
+// Arithmetic modulo each prime is done in Montgomery form (R = 2^64).
+// Only available at run time, and for 64-bit limbs.
+
+template <uint64_t P, uint64_t G, std::size_t E> struct ntt_prime {
+  // P = k 2^E + 1 < 2^62, with primitive root G
+  //
+  // Within the transforms, values are kept in [0, 2 P) and are only fully
+  // reduced at the end ("lazy" reduction, which is possible since 4 P < 2^64)
+
+  using TT = typename dbl_bitlen<uint64_t>::type;
+
+  static constexpr uint64_t p = P;
+
+  static constexpr uint64_t compute_pinv() {
+    // P^-1 mod 2^64 (Newton iteration, doubling the number of correct bits)
+    uint64_t x = P; // correct to 3 bits, as P is odd
+    for (int i = 0; i < 5; ++i)
+      x *= 2 - P * x;
+    return x;
+  }
+
+  static constexpr uint64_t pinv = compute_pinv();
+  static constexpr uint64_t r2 = static_cast<uint64_t>(
+      (static_cast<TT>(-P % P) * static_cast<TT>(-P % P)) % P); // R^2 mod P
+
+  static constexpr uint64_t mul_lazy(uint64_t a, uint64_t b) {
+    // a b R^-1 mod P, in (0, 2 P), for a b < P 2^64 (Montgomery multiplication,
+    // where m = (a b) P^-1 mod 2^64 is chosen such that the low halves of a b
+    // and m P cancel)
+    TT t = static_cast<TT>(a) * b;
+    uint64_t m = static_cast<uint64_t>(t) * pinv;
+    uint64_t mp_hi = (static_cast<TT>(m) * P) >> 64;
+    return static_cast<uint64_t>(t >> 64) - mp_hi + P;
+  }
+
+  static constexpr uint64_t reduce_2p(uint64_t a) {
+    // [0, 4 P) -> [0, 2 P)
+    return (a >= 2 * P) ? a - 2 * P : a;
+  }
+
+  static constexpr uint64_t reduce_p(uint64_t a) {
+    // [0, 2 P) -> [0, P)
+    return (a >= P) ? a - P : a;
+  }
+
+  static constexpr uint64_t mul(uint64_t a, uint64_t b) {
+    return reduce_p(mul_lazy(a, b));
+  }
+
+  static constexpr uint64_t add(uint64_t a, uint64_t b) {
+    return reduce_p(a + b);
+  }
+
+  static constexpr uint64_t sub(uint64_t a, uint64_t b) {
+    return reduce_p(a + P - b);
+  }
+
+  static constexpr uint64_t to_mont(uint64_t a) { return mul(a, r2); }
+
+  static constexpr uint64_t pow(uint64_t a, uint64_t e) {
+    // a^e, where a (and the result) are in Montgomery form
+    uint64_t r = to_mont(1);
+    for (; e; e >>= 1) {
+      if (e & 1)
+        r = mul(r, a);
+      a = mul(a, a);
+    }
+    return r;
+  }
+
+  struct root_table {
+    // roots[e] is a primitive 2^e-th root of unity (Montgomery form),
+    // inverse_roots[e] is its inverse
+    uint64_t roots[E + 1];
+    uint64_t inverse_roots[E + 1];
+  };
+
+  static constexpr root_table compute_roots() {
+    root_table t{};
+    t.roots[E] = pow(to_mont(G), (P - 1) >> E);
+    t.inverse_roots[E] = pow(t.roots[E], P - 2);
+    for (auto e = E; e > 0; --e) {
+      t.roots[e - 1] = mul(t.roots[e], t.roots[e]);
+      t.inverse_roots[e - 1] = mul(t.inverse_roots[e], t.inverse_roots[e]);
+    }
+    return t;
+  }
+
+  static constexpr root_table table = compute_roots();
+
+  static void twiddles(std::vector<uint64_t> &tw, std::size_t half,
+                       std::size_t log_len, bool inverse) {
+    // powers w^j, 0 <= j < half, of the (inverse) root of unity w of order 2 half
+    const auto w = inverse ? table.inverse_roots[log_len] : table.roots[log_len];
+    tw[0] = to_mont(1);
+    for (std::size_t j = 1; j < half; ++j)
+      tw[j] = mul(tw[j - 1], w);
+  }
+
+  static void transform(std::vector<uint64_t> &a, std::vector<uint64_t> &tw,
+                        std::size_t log_L) {
+    // forward transform (decimation in frequency), natural order input,
+    // bit-reversed order output
+    const auto L = a.size();
+    for (auto log_len = log_L; log_len >= 1; --log_len) {
+      const auto len = std::size_t{1} << log_len;
+      const auto half = len / 2;
+      twiddles(tw, half, log_len, false);
+      for (auto lo = a.data(); lo != a.data() + L; lo += len) {
+        auto hi = lo + half;
+        for (std::size_t j = 0; j < half; ++j) {
+          auto x = lo[j];
+          auto y = hi[j];
+          lo[j] = reduce_2p(x + y);
+          hi[j] = mul_lazy(x - y + 2 * P, tw[j]);
+        }
+      }
+    }
+  }
+
+  static void inverse_transform(std::vector<uint64_t> &a,
+                                std::vector<uint64_t> &tw, std::size_t log_L) {
+    // inverse transform (decimation in time), bit-reversed order input,
+    // natural order output, without the division by the length
+    const auto L = a.size();
+    for (std::size_t log_len = 1; log_len <= log_L; ++log_len) {
+      const auto len = std::size_t{1} << log_len;
+      const auto half = len / 2;
+      twiddles(tw, half, log_len, true);
+      for (auto lo = a.data(); lo != a.data() + L; lo += len) {
+        auto hi = lo + half;
+        for (std::size_t j = 0; j < half; ++j) {
+          auto x = lo[j];
+          auto y = mul_lazy(hi[j], tw[j]);
+          lo[j] = reduce_2p(x + y);
+          hi[j] = reduce_2p(x - y + 2 * P);
+        }
+      }
+    }
+  }
+
+  template <std::size_t M, std::size_t N>
+  static std::vector<uint64_t> convolution(const big_int<M, uint64_t> &u,
+                                           const big_int<N, uint64_t> &v,
+                                           std::size_t log_L, bool square) {
+    // the acyclic convolution of the limbs of u and v modulo P (in ordinary
+    // form), computed with transforms of length L = 2^log_L >= M + N - 1
+    const auto L = std::size_t{1} << log_L;
+    std::vector<uint64_t> a(L), b, tw(L / 2);
+    for (std::size_t i = 0; i < M; ++i)
+      a[i] = mul_lazy(u[i], r2);
+    transform(a, tw, log_L);
+
+    if (square) {
+      for (std::size_t i = 0; i < L; ++i)
+        a[i] = mul_lazy(a[i], a[i]);
+    } else {
+      b.resize(L);
+      for (std::size_t i = 0; i < N; ++i)
+        b[i] = mul_lazy(v[i], r2);
+      transform(b, tw, log_L);
+      for (std::size_t i = 0; i < L; ++i)
+        a[i] = mul_lazy(a[i], b[i]);
+    }
+
+    inverse_transform(a, tw, log_L);
+
+    // multiplication by L^-1 (ordinary form) also converts out of
+    // Montgomery form
+    uint64_t L_inv = 1;
+    for (std::size_t i = 0; i < log_L; ++i) // halving modulo P
+      L_inv = (L_inv & 1) ? (L_inv >> 1) + (P >> 1) + 1 : L_inv >> 1;
+    for (std::size_t i = 0; i < M + N - 1; ++i)
+      a[i] = mul(a[i], L_inv);
+    return a;
+  }
+};
+
+using ntt_prime_1 = ntt_prime<4179340454199820289ULL, 3, 57>; // 29 2^57 + 1
+using ntt_prime_2 = ntt_prime<2485986994308513793ULL, 5, 55>; // 69 2^55 + 1
+using ntt_prime_3 = ntt_prime<1945555039024054273ULL, 5, 56>; // 27 2^56 + 1
+
+template <typename Prime>
+constexpr uint64_t ntt_inverse(uint64_t a) {
+  // a^-1 mod P, in Montgomery form (for use as a constant multiplier, i.e.,
+  // Prime::mul(x, ntt_inverse<Prime>(a)) = x a^-1 mod P)
+  return Prime::pow(Prime::to_mont(a % Prime::p), Prime::p - 2);
+}
+
+template <std::size_t M, std::size_t N>
+big_int<M + N, uint64_t> ntt_mul(const big_int<M, uint64_t> &u,
+                                 const big_int<N, uint64_t> &v,
+                                 bool square = false) {
+  // u v, via three NTTs (modulo p1, p2 and p3) and CRT recombination
+
+  using TT = typename dbl_bitlen<uint64_t>::type;
+  using P1 = ntt_prime_1;
+  using P2 = ntt_prime_2;
+  using P3 = ntt_prime_3;
+
+  std::size_t log_L = 0;
+  while ((std::size_t{1} << log_L) < M + N - 1)
+    ++log_L;
+
+  auto r1 = P1::convolution(u, v, log_L, square);
+  auto r2 = P2::convolution(u, v, log_L, square);
+  auto r3 = P3::convolution(u, v, log_L, square);
+
+  // Garner's algorithm: x = v1 + v2 p1 + v3 p1 p2, where
+  //   v1 = r1,
+  //   v2 = (r2 - v1) p1^-1 mod p2,
+  //   v3 = (r3 - v1 - v2 p1) (p1 p2)^-1 mod p3
+  constexpr auto c2 = ntt_inverse<P2>(P1::p);
+  constexpr auto c3 = ntt_inverse<P3>(static_cast<uint64_t>(
+      (static_cast<TT>(P1::p) * P2::p) % P3::p));
+  constexpr auto c31 = P3::mul(P3::to_mont(P1::p % P3::p), c3);
+  constexpr TT p1p2 = static_cast<TT>(P1::p) * P2::p;
+
+  big_int<M + N, uint64_t> w{};
+  TT acc = 0;     // the lower two limbs of the running sum
+  uint64_t hi = 0; // its third limb
+  for (std::size_t k = 0; k < M + N - 1; ++k) {
+    uint64_t v1 = r1[k];
+    uint64_t v2 = P2::sub(P2::mul(r2[k], c2), P2::mul(v1, c2));
+    uint64_t v3 =
+        P3::sub(P3::mul(r3[k], c3), P3::add(P3::mul(v1, c3), P3::mul(v2, c31)));
+
+    // acc += v1 + v2 p1 + v3 p1 p2
+    TT t = static_cast<TT>(v2) * P1::p + v1; // < 2^124
+    TT lo = static_cast<TT>(v3) * static_cast<uint64_t>(p1p2);
+    TT mid = static_cast<TT>(v3) * static_cast<uint64_t>(p1p2 >> 64) + (lo >> 64);
+    TT low_part = (static_cast<TT>(static_cast<uint64_t>(mid)) << 64) |
+                  static_cast<uint64_t>(lo);
+    TT sum = acc + t;
+    hi += (sum < t);
+    acc = sum + low_part;
+    hi += (acc < low_part) + static_cast<uint64_t>(mid >> 64);
+
+    w[k] = static_cast<uint64_t>(acc);
+    acc = (acc >> 64) | (static_cast<TT>(hi) << 64);
+    hi = 0;
+  }
+  w[M + N - 1] = static_cast<uint64_t>(acc);
+  return w;
+}
+
+} // end of detail namespace
+} // end of cbn namespace
+
+#endif
@@ -34,7 +34,7 @@ constexpr auto pow(big_int<N1, T> base, T exp) {
       if (exp == 0)
         break;
     }
-    base = partial_mul<N1>(base, base);
+    base = partial_square<N1>(base);
   }
 
   return result;
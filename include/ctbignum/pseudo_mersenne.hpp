@@ -0,0 +1,123 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#ifndef CT_PSEUDO_MERSENNE_HPP
+#define CT_PSEUDO_MERSENNE_HPP
+
+#include <ctbignum/addition.hpp>
+#include <ctbignum/bigint.hpp>
+#include <ctbignum/bitshift.hpp>
+#include <ctbignum/mult.hpp>
+#include <ctbignum/slicing.hpp>
+#include <ctbignum/utility.hpp>
+
+#include <algorithm>
+#include <cstddef> // std::size_t
+#include <limits>
+#include <utility>
+
+namespace cbn {
+namespace detail {
+
+// Reduction modulo a (pseudo-)Mersenne prime m = 2^k - c, with a small c,
+// e.g., 2^255 - 19, 2^130 - 5, 2^127 - 1 or 2^256 - 2^32 - 977 (secp256k1).
+// Since 2^k = c mod m, the bits of x above the k lower ones can be folded down:
+//   x = hi 2^k + lo = hi c + lo  (mod m),
+// which only takes a multiplication by the single limb c.
+
+template <typename T, T... Modulus> struct pseudo_mersenne_traits {
+  static constexpr auto N = sizeof...(Modulus);
+  static constexpr auto w = std::numeric_limits<T>::digits;
+  static constexpr big_int<N, T> modulus{Modulus...};
+
+  static constexpr std::size_t k = bit_length(modulus);
+
+  // c = 2^k - m (where 0 < c < m)
+  static constexpr auto c_big = first<N>(subtract_ignore_carry(
+      place_at<N + 1, T>(static_cast<T>(1) << (k % w), k / w), pad<1>(modulus)));
+  static constexpr T c = c_big[0];
+  static constexpr std::size_t c_bits = bit_length(big_int<1, T>{c});
+
+  // c must fit in a limb, and c (c + 2) <= 2^k, so that after the last fold
+  // (of a single bit) the result is below 2 m
+  static constexpr bool value =
+      tight_length(c_big) == 1 && c > 0 && 2 * c_bits + 2 <= k;
+};
+
+template <typename T, T... Modulus>
+constexpr bool is_pseudo_mersenne(std::integer_sequence<T, Modulus...>) {
+  return pseudo_mersenne_traits<T, Modulus...>::value;
+}
+
+constexpr std::size_t limbs_for_bits(std::size_t bits, std::size_t w) {
+  return std::max<std::size_t>((bits + w - 1) / w, 1);
+}
+
+template <std::size_t K, typename T, T C, std::size_t N1>
+CBN_ALWAYS_INLINE constexpr auto pseudo_mersenne_fold(big_int<N1, T> x) {
+  // (x mod 2^K) + floor(x / 2^K) C
+  constexpr auto w = std::numeric_limits<T>::digits;
+  constexpr auto L = limbs_for_bits(K, w);
+  static_assert(K / w < N1);
+
+  auto lo = to_length<L>(x);
+  if constexpr (K % w != 0)
+    lo[L - 1] &= static_cast<T>((static_cast<T>(1) << (K % w)) - 1);
+  auto hi = shift_right(skip<K / w>(x), K % w);
+  constexpr auto H = N1 - K / w + 1;
+  constexpr auto R = std::max(L, H) + 1;
+  return add_ignore_carry(to_length<R>(lo),
+                          to_length<R>(mul(hi, big_int<1, T>{C})));
+}
+
+template <typename T, std::size_t Bits, std::size_t N1, T... Modulus>
+constexpr auto pseudo_mersenne_reduce(big_int<N1, T> x,
+                                      std::integer_sequence<T, Modulus...>) {
+  // x mod m, for x < 2^Bits
+  using traits = pseudo_mersenne_traits<T, Modulus...>;
+  constexpr auto N = traits::N;
+  constexpr auto K = traits::k;
+  constexpr auto w = traits::w;
+
+  auto folded = pseudo_mersenne_fold<K, T, traits::c>(
+      to_length<std::max(N1, K / w + 1)>(x));
+
+  if constexpr (Bits > K + 1) {
+    // the fold leaves (at most) max(Bits - K + bits(c), K) + 1 bits
+    constexpr auto next_bits = std::max(Bits - K + traits::c_bits, K) + 1;
+    return pseudo_mersenne_reduce<T, next_bits>(
+        to_length<limbs_for_bits(next_bits, w)>(folded),
+        std::integer_sequence<T, Modulus...>{});
+  } else {
+    // this fold leaves y <= 2^K - 1 + c < 2 m; subtract m if y >= m
+    constexpr auto L = std::max(limbs_for_bits(K + 1, w), N);
+    auto y = to_length<L>(folded);
+    auto d = subtract(y, traits::modulus);
+    y = d[L] ? y : first<L>(d);
+    return first<N>(y);
+  }
+}
+
+} // end of detail namespace
+
+template <typename T, std::size_t N1, T... Modulus>
+constexpr auto pseudo_mersenne_reduction(big_int<N1, T> x,
+                                         std::integer_sequence<T, Modulus...>) {
+  // x mod m, for a compile-time modulus of the form m = 2^k - c with a small c
+  // (see detail::pseudo_mersenne_traits), and inputs of any length
+  static_assert(detail::is_pseudo_mersenne(std::integer_sequence<T, Modulus...>{}),
+                "the modulus is not of the form 2^k - c, with a small c");
+  return detail::pseudo_mersenne_reduce<T, N1 * std::numeric_limits<T>::digits>(
+      x, std::integer_sequence<T, Modulus...>{});
+}
+
+} // end of cbn namespace
+
+#endif
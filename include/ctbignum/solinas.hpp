@@ -0,0 +1,223 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#ifndef CT_SOLINAS_HPP
+#define CT_SOLINAS_HPP
+
+#include <ctbignum/addition.hpp>
+#include <ctbignum/bigint.hpp>
+#include <ctbignum/slicing.hpp>
+#include <ctbignum/utility.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef> // std::size_t
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace cbn {
+namespace detail {
+
+// Reduction modulo a generalized Mersenne prime (Solinas, "Generalized Mersenne
+// Numbers", 1999), such as the NIST primes
+//   P-224 = 2^224 - 2^96 + 1
+//   P-256 = 2^256 - 2^224 + 2^192 + 2^96 - 1
+//   P-384 = 2^384 - 2^128 - 2^96 + 2^32 - 1,
+// i.e., m = 2^k - f, where f has a sparse representation in signed base-2^W
+// digits (W = 32, or the limb size if that is smaller) that are all -1, 0 or 1.
+//
+// Every word of x above the k lower bits is then congruent to a (compile-time)
+// combination of the lower words with small integer coefficients (the schedule
+// of FIPS 186 "fast reduction"), so that x mod m is obtained with word-wise
+// additions and subtractions only, followed by a single correction.
+
+template <typename T, std::size_t J, T... Modulus> struct solinas_traits {
+  static constexpr auto N = sizeof...(Modulus);
+  static constexpr auto w = std::numeric_limits<T>::digits;
+  static constexpr std::size_t W = std::min(w, 32);
+  static constexpr big_int<N, T> modulus{Modulus...};
+
+  static constexpr std::size_t k = bit_length(modulus);
+  static constexpr std::size_t Nw = k / W; // number of words of the modulus
+  static constexpr std::size_t Nz = (N + 1) * (w / W); // number of words of the result
+
+  // signed digits of f = 2^k - m in base 2^W (valid = false if they are not
+  // all in {-1, 0, 1}, or if f needs a digit at position Nw)
+  struct digits_t {
+    std::array<std::int64_t, Nw> d;
+    bool valid;
+  };
+
+  static constexpr digits_t signed_digits() {
+    digits_t r{{}, k % W == 0 && k > W};
+    if (!r.valid)
+      return r;
+    auto f = subtract_ignore_carry(place_at<N + 1, T>(static_cast<T>(1) << (k % w), k / w),
+                                   pad<1>(modulus));
+    std::int64_t carry = 0;
+    for (auto i = 0U; i < Nw; ++i) {
+      std::int64_t word = static_cast<std::int64_t>(
+          (static_cast<std::uint64_t>(f[i * W / w] >> ((i * W) % w))) &
+          ((std::uint64_t(1) << W) - 1)) + carry;
+      carry = 0;
+      if (word >= (std::int64_t(1) << (W - 1))) {
+        word -= std::int64_t(1) << W;
+        carry = 1;
+      }
+      if (word < -1 || word > 1)
+        r.valid = false;
+      r.d[i] = word;
+    }
+    if (carry != 0)
+      r.valid = false;
+    return r;
+  }
+
+  static constexpr digits_t f_digits = signed_digits();
+
+  // table[j][i]: coefficient of word i in (2^W)^(Nw + j) mod m
+  using table_t = std::array<std::array<std::int64_t, Nw>, J>;
+
+  static constexpr table_t schedule() {
+    table_t table{};
+    if (!f_digits.valid)
+      return table;
+    for (auto j = 0U; j < J; ++j) {
+      std::array<std::int64_t, Nw + J> v{};
+      v[Nw + j] = 1;
+      // fold the words from the top down, using (2^W)^Nw = f (mod m)
+      for (auto p = Nw + j; p >= Nw; --p) {
+        auto c = v[p];
+        v[p] = 0;
+        for (auto i = 0U; i < Nw; ++i)
+          v[p - Nw + i] += c * f_digits.d[i];
+      }
+      for (auto i = 0U; i < Nw; ++i)
+        table[j][i] = v[i];
+    }
+    return table;
+  }
+
+  static constexpr table_t table = schedule();
+
+  // bound on the absolute value of the carry out of the column sums
+  static constexpr std::int64_t carry_bound() {
+    std::int64_t sum = 1;
+    for (auto j = 0U; j < J; ++j)
+      for (auto i = 0U; i < Nw; ++i)
+        sum += table[j][i] < 0 ? -table[j][i] : table[j][i];
+    return sum;
+  }
+
+  // the coefficients must stay small, and (carry_bound + 2) f must stay below
+  // 2^k (so that a single correction by m suffices)
+  static constexpr bool value =
+      f_digits.valid && carry_bound() < (1 << 16) &&
+      bit_length(subtract_ignore_carry(place_at<N + 1, T>(static_cast<T>(1) << (k % w), k / w),
+                                       pad<1>(modulus))) +
+              bit_length(big_int<1, std::uint64_t>{
+                  static_cast<std::uint64_t>(carry_bound() + 2)}) <=
+          k;
+};
+
+template <std::size_t W, std::size_t N1, typename T>
+CBN_ALWAYS_INLINE constexpr std::int64_t word_at(big_int<N1, T> x, std::size_t i) {
+  constexpr auto w = std::numeric_limits<T>::digits;
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(x[i * W / w] >> ((i * W) % w)) &
+                                   ((std::uint64_t(1) << W) - 1));
+}
+
+template <typename Traits, std::size_t I, std::size_t N1, typename T, std::size_t... Js>
+CBN_ALWAYS_INLINE constexpr std::int64_t solinas_column(big_int<N1, T> x,
+                                                        std::index_sequence<Js...>) {
+  // word I of x, plus the words above (2^W)^Nw, times their coefficients in
+  // column I (which are compile-time constants, mostly -1, 0 or 1)
+  constexpr auto W = Traits::W;
+  return (word_at<W>(x, I) + ... +
+          (std::get<I>(std::get<Js>(Traits::table)) * word_at<W>(x, Traits::Nw + Js)));
+}
+
+template <typename Traits, std::size_t N1, typename T, std::size_t... Is>
+CBN_ALWAYS_INLINE constexpr auto solinas_columns(big_int<N1, T> x, std::index_sequence<Is...>) {
+  constexpr auto J = std::tuple_size_v<typename Traits::table_t>;
+  return std::array<std::int64_t, sizeof...(Is)>{
+      solinas_column<Traits, Is>(x, std::make_index_sequence<J>{})...};
+}
+
+template <typename T, T... Modulus, std::size_t N1>
+constexpr auto solinas_reduce(big_int<N1, T> x) {
+  constexpr auto w = std::numeric_limits<T>::digits;
+  constexpr auto W = std::min(w, 32);
+  constexpr auto N = sizeof...(Modulus);
+  constexpr auto Nw = bit_length(big_int<N, T>{Modulus...}) / W;
+  using traits = solinas_traits<T, N1 * (w / W) - Nw, Modulus...>;
+  constexpr auto Nz = traits::Nz;
+  constexpr auto mask = static_cast<std::int64_t>((std::uint64_t(1) << W) - 1);
+
+  // x = r + t 2^k, with r < 2^k and a small (signed) t
+  auto s = solinas_columns<traits>(x, std::make_index_sequence<Nw>{});
+  std::int64_t t = 0;
+  for (auto i = 0U; i < Nw; ++i) {
+    t += s[i];
+    s[i] = t & mask;
+    t >>= W;
+  }
+
+  // z = x - t m = r + t f, where -m < z < 2 m
+  // (as Nz words, the upper ones holding the sign extension)
+  std::array<std::int64_t, Nz> z{};
+  std::int64_t carry = 0;
+  for (auto i = 0U; i < Nz; ++i) {
+    if (i < Nw)
+      carry += s[i] + t * traits::f_digits.d[i];
+    z[i] = carry & mask;
+    carry >>= W;
+  }
+
+  big_int<N + 1, T> y{};
+  for (auto i = 0U; i < Nz; ++i)
+    y[i * W / w] |= static_cast<T>(static_cast<T>(z[i]) << ((i * W) % w));
+
+  // a single correction (branch-free selects of z + m, z - m, or z)
+  constexpr auto m = pad<1>(traits::modulus);
+  auto y_plus_m = add_ignore_carry(y, m);
+  auto y_minus_m = subtract_ignore_carry(y, m);
+  y = (y[N] >> (w - 1)) ? y_plus_m : y;
+  y = (y_minus_m[N] >> (w - 1)) ? y : y_minus_m;
+  return first<N>(y);
+}
+
+template <typename T, std::size_t N1, T... Modulus>
+constexpr bool is_generalized_mersenne(std::integer_sequence<T, Modulus...>) {
+  constexpr auto w = std::numeric_limits<T>::digits;
+  constexpr auto N = sizeof...(Modulus);
+  constexpr auto W = std::min(w, 32);
+  constexpr auto k = bit_length(big_int<N, T>{Modulus...});
+  if constexpr (N1 * w < k || k < W)
+    return false;
+  else
+    return solinas_traits<T, N1 * (w / W) - k / W, Modulus...>::value;
+}
+
+} // end of detail namespace
+
+template <typename T, std::size_t N1, T... Modulus>
+constexpr auto solinas_reduction(big_int<N1, T> x, std::integer_sequence<T, Modulus...>) {
+  // x mod m, for a compile-time generalized Mersenne modulus (see
+  // detail::solinas_traits), using word-wise additions and subtractions only
+  static_assert(detail::is_generalized_mersenne<T, N1>(std::integer_sequence<T, Modulus...>{}),
+                "the modulus is not a generalized Mersenne number");
+  return detail::solinas_reduce<T, Modulus...>(x);
+}
+
+} // end of cbn namespace
+
+#endif
@@ -0,0 +1,165 @@
+//
+// This file is part of
+//
+// CTBignum
+//
+// C++ Library for Compile-Time and Run-Time Multi-Precision and Modular Arithmetic
+//
+//
+// This file is distributed under the Apache License, Version 2.0. See the LICENSE
+// file for details.
+#ifndef CT_VIEW_HPP
+#define CT_VIEW_HPP
+
+#include <ctbignum/bigint.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+
+namespace cbn {
+
+// A non-owning view of N limbs (least-significant first) in external memory,
+// e.g., a network buffer or a memory-mapped file, where consecutive limbs are
+// Stride elements apart. Views with a const limb type are read-only.
+//
+// Like std::span, a view has reference semantics: copying a view does not
+// copy the limbs, and it must not outlive the memory it refers to.
+
+template <std::size_t N, typename T = uint64_t, std::size_t Stride = 1>
+requires std::unsigned_integral<std::remove_const_t<T>> && (Stride > 0)
+class big_int_view {
+public:
+  using value_type = std::remove_const_t<T>;
+  using element_type = T;
+
+  constexpr explicit big_int_view(T *limbs) : limbs_(limbs) {}
+
+  constexpr big_int_view(std::span<T, N> limbs) requires(Stride == 1)
+      : limbs_(limbs.data()) {}
+
+  constexpr big_int_view(std::conditional_t<std::is_const_v<T>,
+                                            const big_int<N, value_type>,
+                                            big_int<N, value_type>> &x)
+      requires(Stride == 1)
+      : limbs_(x.data()) {}
+
+  // a read-only view of a writable one
+  template <typename U>
+  requires std::is_const_v<T> && std::same_as<U, value_type>
+  constexpr big_int_view(big_int_view<N, U, Stride> v) : limbs_(v.data()) {}
+
+  static constexpr std::size_t size() { return N; }
+  static constexpr std::size_t stride() { return Stride; }
+  constexpr T *data() const { return limbs_; }
+
+  constexpr T &operator[](std::size_t i) const { return limbs_[i * Stride]; }
+
+  constexpr big_int<N, value_type> load() const {
+    // a copy of the limbs, as a big_int
+    big_int<N, value_type> x{};
+    for (auto i = 0U; i < N; ++i)
+      x[i] = (*this)[i];
+    return x;
+  }
+
+  constexpr operator big_int<N, value_type>() const { return load(); }
+
+  constexpr void store(const big_int<N, value_type> &x) const
+      requires(!std::is_const_v<T>) {
+    for (auto i = 0U; i < N; ++i)
+      (*this)[i] = x[i];
+  }
+
+private:
+  T *limbs_;
+};
+
+template <std::size_t N, typename T>
+big_int_view(big_int<N, T> &) -> big_int_view<N, T>;
+
+template <std::size_t N, typename T>
+big_int_view(const big_int<N, T> &) -> big_int_view<N, const T>;
+
+template <typename T, std::size_t N>
+big_int_view(std::span<T, N>) -> big_int_view<N, T>;
+
+namespace detail {
+
+// The number of limbs and the limb type of big_ints and views, for the
+// functions that accept either of them
+
+template <typename X> struct limb_traits {};
+
+template <std::size_t N, typename T> struct limb_traits<big_int<N, T>> {
+  static constexpr std::size_t size = N;
+  using type = T;
+  static constexpr bool is_view = false;
+  static constexpr bool writable = true;
+};
+
+template <std::size_t N, typename T, std::size_t Stride>
+struct limb_traits<big_int_view<N, T, Stride>> {
+  static constexpr std::size_t size = N;
+  using type = std::remove_const_t<T>;
+  static constexpr bool is_view = true;
+  static constexpr bool writable = !std::is_const_v<T>;
+};
+
+template <typename X> using limb_traits_t = limb_traits<std::remove_cvref_t<X>>;
+
+template <typename X>
+concept limb_sequence = requires { limb_traits_t<X>::size; };
+
+// a non-const big_int lvalue, or a writable view (of any value category)
+template <typename X>
+concept writable_limb_sequence =
+    limb_sequence<X> && limb_traits_t<X>::writable &&
+    (limb_traits_t<X>::is_view ||
+     (std::is_lvalue_reference_v<X> &&
+      !std::is_const_v<std::remove_reference_t<X>>));
+
+template <std::size_t Offset, std::size_t Length, typename X>
+requires limb_sequence<X> &&
+         (limb_traits_t<X>::is_view || std::is_lvalue_reference_v<X>)
+constexpr auto subview(X &&x) {
+  // the limbs [Offset, Offset + Length) of a big_int or a view, as a view
+  // (read-only, for a const big_int), i.e., a slice that is not copied
+  static_assert(Offset + Length <= limb_traits_t<X>::size, "invalid range");
+  using V = std::remove_cvref_t<X>;
+  if constexpr (limb_traits_t<X>::is_view)
+    return big_int_view<Length, typename V::element_type, V::stride()>(
+        x.data() + Offset * V::stride());
+  else {
+    using E = std::conditional_t<std::is_const_v<std::remove_reference_t<X>>,
+                                 const typename V::value_type,
+                                 typename V::value_type>;
+    return big_int_view<Length, E>(x.data() + Offset);
+  }
+}
+
+template <typename X>
+requires limb_sequence<X>
+constexpr decltype(auto) load(const X &x) {
+  // the value of a big_int or a view, as a big_int (copies only views)
+  if constexpr (limb_traits_t<X>::is_view)
+    return x.load();
+  else
+    return (x);
+}
+
+template <typename X, typename Y>
+requires writable_limb_sequence<X>
+constexpr void store(X &&x, const Y &y) {
+  // assignment to a big_int or to the limbs of a view
+  if constexpr (limb_traits_t<X>::is_view)
+    x.store(y);
+  else
+    x = y;
+}
+
+} // end of detail namespace
+} // end of cbn namespace
+
+#endif
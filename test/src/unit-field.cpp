@@ -60,6 +60,23 @@ TEST_CASE("Finite Field class") {
     static_assert((x * y).data == result.data);
   }
 
+  SECTION("Multiplication by a compile-time constant") {
+
+    using GF101 = decltype(Zq(1267650600228229401496703205653_Z));
+
+    constexpr GF101 x(543195761203162351763512095426_Z);
+    constexpr auto c = 213461909783715623473362549_Z;
+
+    auto z = x;
+    z *= c;
+
+    REQUIRE(z == x * GF101(c));
+    static_assert(x * c == x * GF101(c));
+    static_assert(c * x == x * GF101(c));
+    static_assert(x * 8_Z == x * GF101(8_Z));
+    static_assert(x * 0_Z == GF101(0_Z));
+  }
+
   SECTION("Compound addition assignment and addition") {
 
     using GF101 = decltype(Zq(1267650600228229401496703205653_Z));
@@ -127,3 +144,56 @@ TEST_CASE("Finite Field class - output to stream") {
   REQUIRE(ss.str() == "4387682521574012837928367540");
 }
 
+TEST_CASE("Finite Field class - Montgomery representation") {
+
+  using namespace cbn;
+  using namespace cbn::literals;
+
+  using GF101 = decltype(MontgomeryZq(1267650600228229401496703205653_Z));
+
+  SECTION("Initialization") {
+
+    constexpr GF101 y{1268888540267514781771602329707_Z};
+    constexpr auto result = to_big_int(1237940039285380274899124054_Z);
+
+    static_assert(static_cast<big_int<2>>(y) == result);
+    REQUIRE(static_cast<big_int<2>>(y) == result);
+    REQUIRE(static_cast<big_int<2>>(GF101{to_big_int(1268888540267514781771602329707_Z)}) == result);
+    REQUIRE(static_cast<big_int<2>>(GF101{-1}) ==
+            to_big_int(1267650600228229401496703205652_Z));
+  }
+
+  SECTION("Arithmetic agrees with the plain representation") {
+
+    using GF = decltype(Zq(1267650600228229401496703205653_Z));
+
+    constexpr GF101 x(543195761203162758351763512095426_Z);
+    constexpr GF101 y(213461909783715623473362549_Z);
+    constexpr GF u(543195761203162758351763512095426_Z);
+    constexpr GF v(213461909783715623473362549_Z);
+
+    auto z = x;
+    z *= y;
+    REQUIRE(static_cast<big_int<2>>(z) == (u * v).data);
+    static_assert(static_cast<big_int<2>>(x * y) == (u * v).data);
+    static_assert(static_cast<big_int<2>>(x + y) == (u + v).data);
+    static_assert(static_cast<big_int<2>>(y - x) == (v - u).data);
+    static_assert(static_cast<big_int<2>>(-x) == (-u).data);
+    static_assert(static_cast<big_int<2>>(x / y) == (u / v).data);
+    REQUIRE(x / y * y == x);
+
+    auto c = 213461909783715623473362549_Z;
+    auto w = x;
+    w *= c;
+    REQUIRE(w == x * y);
+    static_assert(static_cast<big_int<2>>(c * x) == (u * v).data);
+    static_assert(x * 18446744073709551616_Z == x * GF101(18446744073709551616_Z));
+  }
+
+  SECTION("Output to stream") {
+    constexpr GF101 num{4387682521574012837928367540_Z};
+    std::stringstream ss;
+    ss << num;
+    REQUIRE(ss.str() == "4387682521574012837928367540");
+  }
+}
@@ -12,6 +12,44 @@
 
 #include <ctbignum/ctbignum.hpp>
 
+#include <random>
+
+template <typename BigInt> BigInt random_limbs(std::mt19937_64 &gen) {
+  BigInt x{};
+  for (auto &limb : x)
+    limb = static_cast<typename BigInt::value_type>(gen());
+  return x;
+}
+
+template <typename T, T... Modulus, typename... Inputs>
+void check_modulus(std::integer_sequence<T, Modulus...> m, Inputs... inputs) {
+  // compares mod (and the reduction that it dispatches to, for special
+  // moduli) with long division, for the given inputs, for inputs of all ones,
+  // and for the values just below and above the modulus (and m itself)
+  using namespace cbn;
+  auto modulus = to_big_int(m);
+
+  auto check_one = [&]<std::size_t K>(big_int<K, T> u) {
+    auto expected = div(u, modulus).remainder;
+    REQUIRE(mod(u, m) == expected);
+    if constexpr (detail::is_pseudo_mersenne(std::integer_sequence<T, Modulus...>{}))
+      REQUIRE(pseudo_mersenne_reduction(u, m) == expected);
+    else if constexpr (detail::is_generalized_mersenne<T, K>(
+                           std::integer_sequence<T, Modulus...>{}))
+      REQUIRE(solinas_reduction(u, m) == expected);
+  };
+
+  auto check_length = [&](auto u) {
+    check_one(u);
+    check_one(subtract_ignore_carry(decltype(u){}, decltype(u){1}));
+  };
+  (check_length(inputs), ...);
+
+  for (T i = 0; i < 3; ++i)
+    check_one(add_ignore_carry(detail::pad<1>(subtract_ignore_carry(modulus, decltype(modulus){1})),
+                               big_int<sizeof...(Modulus) + 1, T>{i}));
+}
+
 TEST_CASE("Test division invariant integer") {
 
   using namespace cbn;
@@ -68,4 +106,173 @@ TEST_CASE("Test division invariant integer") {
 
   }
 
+  SECTION("Comparison with long division") {
+    auto d = 115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+    constexpr auto dd = to_big_int(d);
+    auto x = to_big_int(1725436586697640946858688965569256363112777243042596638790631055949891_Z);
+    for (auto i = 0; i < 10; ++i) {
+      auto n = mul(x, x);
+      REQUIRE(quotient(n, d) == div(n, dd).quotient);
+      REQUIRE(mod(n, d) == div(n, dd).remainder);
+      auto qr = div(n, d);
+      REQUIRE(qr.quotient == div(n, dd).quotient);
+      REQUIRE(qr.remainder == div(n, dd).remainder);
+      x = add_ignore_carry(x, detail::to_length<4>(detail::first<3>(n)));
+    }
+  }
+
+}
+
+TEST_CASE("Division by a runtime invariant divisor") {
+
+  using namespace cbn;
+  using namespace cbn::literals;
+
+  constexpr auto n = to_big_int(1237940039285380274899124054_Z);
+  constexpr divisor<2> d7(big_int<2>{7});
+  static_assert(d7.quotient(n) == div(n, big_int<2>{7}).quotient);
+  static_assert(mod(n, d7) == div(n, big_int<2>{7}).remainder);
+
+  std::mt19937_64 gen(42);
+
+  auto check = [&](auto d, auto &&...dividends) {
+    divisor dd(d);
+    auto check_one = [&](auto u) {
+      auto expected = div(u, d);
+      auto qr = div(u, dd);
+      REQUIRE(qr.quotient == expected.quotient);
+      REQUIRE(qr.remainder == expected.remainder);
+      REQUIRE(quotient(u, dd) == expected.quotient);
+      REQUIRE(mod(u, dd) == expected.remainder);
+    };
+    (check_one(dividends), ...);
+  };
+
+  using B3 = big_int<3>;
+  using B6 = big_int<6>;
+  const B6 ones = subtract_ignore_carry(B6{}, B6{1});
+
+  check(B3{1}, random_limbs<B6>(gen), ones);
+  for (auto k = 1U; k < 192; k += 13)
+    check(detail::first<3>(shift_left(detail::place_at<3>(uint64_t{1}, k / 64), k % 64)),
+          random_limbs<B6>(gen), ones, random_limbs<big_int<2>>(gen));
+
+  for (auto i = 0; i < 50; ++i) {
+    auto d = random_limbs<B3>(gen);
+    check(d, random_limbs<B6>(gen), ones, B6{}, detail::pad<3>(d),
+          random_limbs<big_int<4>>(gen));
+    d[2] = 0;
+    check(d, random_limbs<B6>(gen), ones, random_limbs<big_int<2>>(gen));
+    d[1] = 0;
+    check(d, random_limbs<B6>(gen), ones);
+    d[2] |= uint64_t(1) << 63;
+    check(d, random_limbs<B6>(gen), ones);
+
+    auto e = random_limbs<big_int<4, uint32_t>>(gen);
+    check(e, random_limbs<big_int<8, uint32_t>>(gen));
+    e[3] >>= 17;
+    check(e, random_limbs<big_int<8, uint32_t>>(gen));
+  }
+
+  // dividends as long as the divisor (where ell may equal the full length)
+  for (auto i = 0; i < 20; ++i) {
+    auto d = random_limbs<big_int<2>>(gen);
+    d[1] |= uint64_t(1) << 63;
+    for (auto f : {d, shift_right(d, 1)}) {
+      divisor<2, uint64_t, 2> dd(f);
+      const auto ones2 = subtract_ignore_carry(big_int<2>{}, big_int<2>{1});
+      for (auto u : {random_limbs<big_int<2>>(gen), ones2, f}) {
+        REQUIRE(div(u, dd).quotient == div(u, f).quotient);
+        REQUIRE(div(u, dd).remainder == div(u, f).remainder);
+      }
+    }
+  }
+}
+
+TEST_CASE("Reduction modulo a pseudo-Mersenne prime") {
+
+  using namespace cbn;
+  using namespace cbn::literals;
+
+  auto p25519 = 57896044618658097711785492504343953926634992332820282019728792003956564819949_Z;
+  auto p130 = 1361129467683753853853498429727072845819_Z;
+  auto p127 = 170141183460469231731687303715884105727_Z;
+  auto secp256k1 = 115792089237316195423570985008687907853269984665640564039457584007908834671663_Z;
+  auto p61 = std::integer_sequence<uint64_t, (uint64_t(1) << 61) - 1>{};
+  auto p25519_32 = std::integer_sequence<uint32_t, 0xffffffed, 0xffffffff, 0xffffffff, 0xffffffff,
+                                         0xffffffff, 0xffffffff, 0xffffffff, 0x7fffffff>{};
+
+  static_assert(detail::is_pseudo_mersenne(p25519));
+  static_assert(detail::is_pseudo_mersenne(p130));
+  static_assert(detail::is_pseudo_mersenne(p127));
+  static_assert(detail::is_pseudo_mersenne(secp256k1));
+  static_assert(detail::is_pseudo_mersenne(p61));
+  static_assert(detail::is_pseudo_mersenne(p25519_32));
+  static_assert(!detail::is_pseudo_mersenne(
+      115792089210356248762697446949407573530086143415290314195533631308867097853951_Z));
+  static_assert(!detail::is_pseudo_mersenne(std::integer_sequence<uint64_t, uint64_t(1) << 63>{}));
+
+  constexpr auto x = to_big_int(
+      1918364187619837651267354918237508463169875469187436983576158736587620837561389746587368276987232_Z);
+  static_assert(mod(x, p25519) == div(x, to_big_int(p25519)).remainder);
+
+  std::mt19937_64 gen(7);
+
+  for (auto i = 0; i < 50; ++i) {
+    check_modulus(p25519, random_limbs<big_int<8>>(gen), random_limbs<big_int<5>>(gen),
+                  random_limbs<big_int<4>>(gen), random_limbs<big_int<17>>(gen));
+    check_modulus(p130, random_limbs<big_int<6>>(gen), random_limbs<big_int<3>>(gen));
+    check_modulus(p127, random_limbs<big_int<4>>(gen), random_limbs<big_int<2>>(gen));
+    check_modulus(secp256k1, random_limbs<big_int<8>>(gen), random_limbs<big_int<4>>(gen));
+    check_modulus(p61, random_limbs<big_int<2>>(gen), random_limbs<big_int<1>>(gen));
+    check_modulus(p25519_32, random_limbs<big_int<16, uint32_t>>(gen));
+  }
+
+  // multiplication in a field modulo a pseudo-Mersenne prime
+  using GF = decltype(Zq(p25519));
+  GF a(random_limbs<big_int<4>>(gen)), b(random_limbs<big_int<4>>(gen));
+  auto ab = a * b;
+  REQUIRE(ab.data == div(mul(a.data, b.data), to_big_int(p25519)).remainder);
+}
+
+TEST_CASE("Reduction modulo a generalized Mersenne prime") {
+
+  using namespace cbn;
+  using namespace cbn::literals;
+
+  auto p192 = 6277101735386680763835789423207666416083908700390324961279_Z;
+  auto p224 = 26959946667150639794667015087019630673557916260026308143510066298881_Z;
+  auto p256 = 115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+  auto p384 = 39402006196394479212279040100143613805079739270465446667948293404245721771496870329047266088258938001861606973112319_Z;
+  auto p256_32 = std::integer_sequence<uint32_t, 0xffffffff, 0xffffffff, 0xffffffff, 0, 0, 0, 1,
+                                       0xffffffff>{};
+
+  static_assert(detail::is_generalized_mersenne<uint64_t, 8>(p256));
+  static_assert(detail::is_generalized_mersenne<uint64_t, 12>(p384));
+  static_assert(detail::is_generalized_mersenne<uint64_t, 8>(p224));
+  static_assert(detail::is_generalized_mersenne<uint64_t, 6>(p192));
+  static_assert(detail::is_generalized_mersenne<uint32_t, 16>(p256_32));
+  static_assert(!detail::is_generalized_mersenne<uint64_t, 8>(
+      57896044618658097711785492504343953926634992332820282019728792003956564819951_Z));
+
+  constexpr auto x = to_big_int(
+      1918364187619837651267354918237508463169875469187436983576158736587620837561389746587368276987232_Z);
+  static_assert(mod(x, p256) == div(x, to_big_int(p256)).remainder);
+
+  std::mt19937_64 gen(11);
+
+  for (auto i = 0; i < 50; ++i) {
+    check_modulus(p256, random_limbs<big_int<8>>(gen), random_limbs<big_int<5>>(gen),
+                  random_limbs<big_int<4>>(gen));
+    check_modulus(p384, random_limbs<big_int<12>>(gen), random_limbs<big_int<6>>(gen));
+    check_modulus(p224, random_limbs<big_int<8>>(gen), random_limbs<big_int<7>>(gen));
+    check_modulus(p192, random_limbs<big_int<6>>(gen), random_limbs<big_int<3>>(gen));
+    check_modulus(p256_32, random_limbs<big_int<16, uint32_t>>(gen));
+  }
+
+  // multiplication in a field modulo a generalized Mersenne prime
+  using GF = decltype(Zq(p256));
+  GF a(random_limbs<big_int<4>>(gen)), b(random_limbs<big_int<4>>(gen));
+  auto ab = a * b;
+  REQUIRE(ab.data == div(mul(a.data, b.data), to_big_int(p256)).remainder);
 }
@@ -20,13 +20,17 @@
 #include <ctbignum/io.hpp>
 #include <ctbignum/mod_exp.hpp>
 #include <ctbignum/montgomery.hpp>
+#include <ctbignum/montgomery_context.hpp>
 #include <ctbignum/mult.hpp>
+#include <ctbignum/pow.hpp>
 #include <ctbignum/print.hpp>
 #include <ctbignum/relational_ops.hpp>
 #include <ctbignum/slicing.hpp>
 
 #include <iostream>
 #include <random>
+#include <span>
+#include <vector>
 
 using namespace std;
 using namespace cbn::literals;
@@ -120,7 +124,336 @@ TEST_CASE("Multiplication") {
 
 }
 
-/*
+template <size_t N> constexpr auto pseudo_random_big_int(uint64_t seed) {
+  cbn::big_int<N> x{};
+  for (auto &limb : x) {
+    seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+    limb = seed ^ (seed >> 29);
+  }
+  return x;
+}
+
+template <size_t N> constexpr auto montgomery_mul_operands(uint64_t seed) {
+  auto m = pseudo_random_big_int<N>(seed);
+  auto x = pseudo_random_big_int<N>(seed + 1000);
+  auto y = pseudo_random_big_int<N>(seed + 2000);
+  m[0] |= 1;
+  m[N - 1] |= uint64_t(1) << 63;
+  x[N - 1] %= m[N - 1];
+  y[N - 1] %= m[N - 1];
+  return std::array<cbn::big_int<N>, 3>{m, x, y};
+}
+
+TEST_CASE("Modular addition and subtraction (random operands)") {
+
+  using namespace cbn;
+
+  // moduli with the most significant bit set, so that the additions carry
+  constexpr auto m = subtract_ignore_carry(big_int<4>{}, big_int<4>{189});
+  constexpr auto m32 = subtract_ignore_carry(big_int<6, uint32_t>{},
+                                             big_int<6, uint32_t>{5, 1});
+  static_assert(mod_add(subtract_ignore_carry(m, big_int<4>{1}), big_int<4>{2}, m) ==
+                big_int<4>{1});
+  static_assert(mod_sub(big_int<4>{1}, big_int<4>{2}, m) ==
+                subtract_ignore_carry(m, big_int<4>{1}));
+
+  for (uint64_t seed = 0; seed < 20; ++seed) {
+    auto a = pseudo_random_big_int<4>(seed) % m;
+    auto b = pseudo_random_big_int<4>(seed + 100) % m;
+    REQUIRE(mod_add(a, b, m) == detail::first<4>(add(a, b) % m));
+    REQUIRE(mod_sub(a, b, m) ==
+            detail::first<4>(subtract_ignore_carry(add(a, m), detail::pad<1>(b)) % m));
+    REQUIRE(mod_add(a, b, m) == mod_add(b, a, m));
+    REQUIRE(mod_sub(mod_add(a, b, m), b, m) == a);
+
+    big_int<6, uint32_t> x{}, y{};
+    for (auto i = 0U; i < 6; ++i) {
+      x[i] = static_cast<uint32_t>(a[i % 4] >> (i / 4) * 32);
+      y[i] = static_cast<uint32_t>(b[i % 4] >> (i / 4) * 32);
+    }
+    x = x % m32;
+    y = y % m32;
+    REQUIRE(mod_add(x, y, m32) == detail::first<6>(add(x, y) % m32));
+    REQUIRE(mod_sub(mod_add(x, y, m32), y, m32) == x);
+  }
+}
+
+TEST_CASE("Multi-operand addition") {
+
+  using namespace cbn;
+
+  constexpr auto a = pseudo_random_big_int<4>(1);
+  constexpr auto b = pseudo_random_big_int<4>(2);
+  constexpr auto c = pseudo_random_big_int<4>(3);
+  static_assert(add_many(a, b, c) == add(add(a, b), c));
+  static_assert(add_many(a) == detail::pad<1>(a));
+
+  std::vector<big_int<4>> xs;
+  big_int<5> expected{};
+  for (uint64_t seed = 0; seed < 1000; ++seed) {
+    xs.push_back(pseudo_random_big_int<4>(seed));
+    expected = add_ignore_carry(expected, detail::pad<1>(xs.back()));
+  }
+  REQUIRE(add_many(std::span{xs}) == expected);
+  REQUIRE(add_many(std::span<const big_int<4>>(xs).first(2)) == add(xs[0], xs[1]));
+
+  // maximal column sums
+  big_int<3, uint32_t> ones{~0U, ~0U, ~0U};
+  std::vector<big_int<3, uint32_t>> ys(300, ones);
+  REQUIRE(add_many(std::span{ys}) ==
+          detail::first<4>(mul(ones, big_int<1, uint32_t>{300})));
+  std::vector<big_int<2>> zs(5, big_int<2>{~0UL, ~0UL});
+  REQUIRE(add_many(std::span{zs}) ==
+          detail::first<3>(mul(zs[0], big_int<1>{5})));
+
+  // at most 2^w operands
+  std::vector<big_int<2, uint8_t>> bytes(256, big_int<2, uint8_t>{0xff, 0xff});
+  REQUIRE(add_many(std::span{bytes}) == big_int<3, uint8_t>{0x00, 0xff, 0xff});
+  bytes.push_back(big_int<2, uint8_t>{1});
+  REQUIRE_THROWS_AS(add_many(std::span{bytes}), std::length_error);
+}
+
+TEST_CASE("Karatsuba multiplication") {
+
+  using namespace cbn;
+
+  constexpr auto a = pseudo_random_big_int<32>(1);
+  constexpr auto b = pseudo_random_big_int<32>(2);
+  static_assert(mul(a, b) == detail::schoolbook_mul(a, b));
+  static_assert(partial_mul<32>(a, b) == detail::schoolbook_partial_mul<32>(a, b));
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto x = pseudo_random_big_int<64>(seed);
+    auto y = pseudo_random_big_int<64>(seed + 100);
+    auto z = pseudo_random_big_int<25>(seed + 200);
+    auto w = pseudo_random_big_int<50>(seed + 300);
+
+    REQUIRE(mul(x, y) == detail::schoolbook_mul(x, y));
+    REQUIRE(mul(z, x) == detail::schoolbook_mul(z, x));
+    REQUIRE(mul(w, z) == detail::schoolbook_mul(w, z));
+    REQUIRE(partial_mul<64>(x, y) == detail::schoolbook_partial_mul<64>(x, y));
+    REQUIRE(partial_mul<70>(x, w) == detail::schoolbook_partial_mul<70>(x, w));
+  }
+}
+
+TEST_CASE("NTT multiplication") {
+
+  using namespace cbn;
+
+  for (uint64_t seed = 0; seed < 5; ++seed) {
+    auto x = pseudo_random_big_int<130>(seed);
+    auto y = pseudo_random_big_int<130>(seed + 100);
+    auto z = pseudo_random_big_int<40>(seed + 200);
+    auto w = pseudo_random_big_int<3>(seed + 300);
+
+    REQUIRE(detail::ntt_mul(x, y) == detail::karatsuba_mul(x, y));
+    REQUIRE(detail::ntt_mul(z, x) == detail::schoolbook_mul(z, x));
+    REQUIRE(detail::ntt_mul(w, z) == detail::schoolbook_mul(w, z));
+    REQUIRE(detail::ntt_mul(x, x, true) == detail::karatsuba_mul(x, x));
+  }
+
+  // all-ones operands give the largest convolution coefficients
+  big_int<300> ones{};
+  for (auto &limb : ones)
+    limb = ~uint64_t(0);
+  REQUIRE(detail::ntt_mul(ones, ones, true) == detail::karatsuba_mul(ones, ones));
+}
+
+TEST_CASE("Product scanning") {
+
+  using namespace cbn;
+
+  constexpr auto a = pseudo_random_big_int<5>(1);
+  constexpr auto b = pseudo_random_big_int<3>(2);
+  static_assert(mul(a, b, product_scanning{}) == mul(a, b));
+  static_assert(mul<1>(b, a, product_scanning{}) == mul<1>(b, a));
+  static_assert(partial_mul<4>(a, b, product_scanning{}) == partial_mul<4>(a, b));
+
+  constexpr auto modulus_seq = 1267650600228229401496703205653_Z;
+  constexpr auto m = to_big_int(modulus_seq);
+  constexpr uint64_t mprime = 1265300135019788739UL;
+  constexpr auto x = to_big_int(924750812939937572408690850011_Z);
+  constexpr auto y = to_big_int(478633290783786461322094322310_Z);
+  static_assert(montgomery_mul(x, y, modulus_seq, product_scanning{}) ==
+                montgomery_mul(x, y, modulus_seq));
+  static_assert(montgomery_mul(x, y, m, mprime, product_scanning{}) ==
+                montgomery_mul(x, y, m, mprime, operand_scanning{}));
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto u = pseudo_random_big_int<9>(seed);
+    auto v = pseudo_random_big_int<7>(seed + 100);
+    REQUIRE(mul(u, v, product_scanning{}) == mul(u, v));
+    REQUIRE(partial_mul<9>(u, v, product_scanning{}) == partial_mul<9>(u, v));
+
+    auto [m6, x6, y6] = montgomery_mul_operands<6>(seed);
+    auto mprime6 = -detail::inverse_mod(m6[0]);
+    REQUIRE(montgomery_mul(x6, y6, m6, mprime6, product_scanning{}) ==
+            montgomery_mul(x6, y6, m6, mprime6));
+  }
+}
+
+TEST_CASE("Delayed carry propagation (32-bit limbs)") {
+
+  using namespace cbn;
+
+  auto narrow = [](auto x) {
+    // reinterpret 64-bit limbs as twice as many 32-bit limbs
+    big_int<2 * x.size(), uint32_t> y{};
+    for (auto i = 0U; i < x.size(); ++i) {
+      y[2 * i] = static_cast<uint32_t>(x[i]);
+      y[2 * i + 1] = static_cast<uint32_t>(x[i] >> 32);
+    }
+    return y;
+  };
+
+  constexpr auto a = narrow(pseudo_random_big_int<15>(1));
+  constexpr auto b = narrow(pseudo_random_big_int<12>(2));
+  static_assert(mul(a, b) == mul(a, b, product_scanning{}));
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto u = narrow(pseudo_random_big_int<15>(seed));
+    auto v = narrow(pseudo_random_big_int<13>(seed + 100));
+    auto w = narrow(pseudo_random_big_int<150>(seed + 200));
+    REQUIRE(mul(u, v) == mul(u, v, product_scanning{}));
+    REQUIRE(mul(v, v) == square(v));
+    REQUIRE(mul(w, u) == mul(w, u, product_scanning{}));
+    REQUIRE(mul(w, w) == square(w));
+    REQUIRE(square(w) == mul(w, w, product_scanning{}));
+    REQUIRE(partial_mul<40>(w, u) == partial_mul<40>(w, u, product_scanning{}));
+    REQUIRE(partial_mul<350>(w, w) == partial_mul<350>(w, w, product_scanning{}));
+    REQUIRE(partial_square<350>(w) == partial_mul<350>(w, w, product_scanning{}));
+    REQUIRE(partial_square<20>(u) == partial_mul<20>(u, u, product_scanning{}));
+
+    auto [m, x, y] = montgomery_mul_operands<16>(seed);
+    auto m32 = narrow(m);
+    auto x32 = narrow(x);
+    auto y32 = narrow(y);
+    uint32_t mprime = -detail::inverse_mod(m32[0]);
+    REQUIRE(montgomery_mul(x32, y32, m32, mprime) ==
+            montgomery_mul(x32, y32, m32, mprime, product_scanning{}));
+  }
+
+  big_int<40, uint32_t> ones{};
+  for (auto &limb : ones)
+    limb = ~uint32_t(0);
+  REQUIRE(mul(ones, ones) == mul(ones, ones, product_scanning{}));
+  REQUIRE(square(ones) == mul(ones, ones, product_scanning{}));
+  REQUIRE(partial_square<50>(ones) == partial_mul<50>(ones, ones, product_scanning{}));
+}
+
+TEST_CASE("Multiplication by a compile-time constant") {
+
+  using namespace cbn;
+
+  // dense constant, constant with zero limbs, powers of two
+  constexpr auto p256 = 115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+  constexpr auto two_pow_64 = 18446744073709551616_Z;
+  constexpr auto two_pow_127 = 170141183460469231731687303715884105728_Z;
+
+  constexpr auto a = pseudo_random_big_int<3>(1);
+  static_assert(mul(a, p256) == mul(a, to_big_int(p256)));
+  static_assert(mul(a, 3_Z) == mul(a, big_int<1>{3}));
+  static_assert(mul(a, two_pow_64) == mul(a, to_big_int(two_pow_64)));
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto u = pseudo_random_big_int<5>(seed);
+    REQUIRE(mul(u, p256) == mul(u, to_big_int(p256)));
+    REQUIRE(mul(u, 1_Z) == mul(u, big_int<1>{1}));
+    REQUIRE(mul(u, two_pow_127) == mul(u, to_big_int(two_pow_127)));
+    REQUIRE(mul(u, 1267650600228229401496703205653_Z) ==
+            mul(u, to_big_int(1267650600228229401496703205653_Z)));
+  }
+}
+
+TEST_CASE("Fused multiply-add") {
+
+  using namespace cbn;
+
+  constexpr auto a = pseudo_random_big_int<4>(1);
+  constexpr auto b = pseudo_random_big_int<3>(2);
+  constexpr auto c = pseudo_random_big_int<4>(3);
+  static_assert(mul_add(a, b, c) == add(mul(a, b), c));
+  static_assert(mul_add_mul(a, b, c, b) == add(mul(a, b), mul(c, b)));
+  static_assert(mul_sub(a, b, c) == detail::first<7>(subtract(mul(a, b), c)));
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto u = pseudo_random_big_int<5>(seed);
+    auto v = pseudo_random_big_int<3>(seed + 100);
+    auto w = pseudo_random_big_int<9>(seed + 200);
+    auto x = pseudo_random_big_int<2>(seed + 300);
+
+    REQUIRE(mul_add(u, v, x) == add(mul(u, v), x));
+    REQUIRE(mul_add(v, u, x) == add(mul(u, v), x));
+    REQUIRE(mul_add(u, v, w) == add(mul(u, v), w));
+    REQUIRE(mul_add_mul(u, v, w, x) == add(mul(u, v), mul(w, x)));
+    REQUIRE(mul_sub(w, x, u) == detail::first<11>(subtract(mul(w, x), u)));
+  }
+}
+
+TEST_CASE("Sum of two products with a single reduction") {
+
+  using namespace cbn;
+
+  constexpr auto modulus = 115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+  constexpr auto m = to_big_int(modulus);
+  constexpr auto mprime = -detail::inverse_mod(m[0]);
+  constexpr auto mu = div(detail::unary_encoding<8, 9>(), m).quotient;
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto a = pseudo_random_big_int<4>(seed) % m;
+    auto b = pseudo_random_big_int<4>(seed + 100) % m;
+    auto c = pseudo_random_big_int<4>(seed + 200) % m;
+    auto d = pseudo_random_big_int<4>(seed + 300) % m;
+
+    auto expected = mod_add(montgomery_mul(a, b, modulus),
+                            montgomery_mul(c, d, modulus), m);
+    REQUIRE(montgomery_mul_add_mul(a, b, c, d, modulus) == expected);
+    REQUIRE(montgomery_mul_add_mul(a, b, c, d, m, mprime) == expected);
+
+    auto sum = add(mul(a, b), mul(c, d)) % m;
+    REQUIRE(barrett_mul_add_mul(a, b, c, d, modulus) == sum);
+    REQUIRE(barrett_mul_add_mul(a, b, c, d, m, mu) == sum);
+  }
+
+  // moduli of up to 7 limbs, with operands close to the modulus
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto [m7, x7, y7] = montgomery_mul_operands<7>(seed);
+    auto mprime7 = -detail::inverse_mod(m7[0]);
+    auto z7 = subtract_ignore_carry(m7, big_int<7>{1});
+    REQUIRE(montgomery_mul_add_mul(x7, y7, z7, z7, m7, mprime7) ==
+            mod_add(montgomery_mul(x7, y7, m7, mprime7),
+                    montgomery_mul(z7, z7, m7, mprime7), m7));
+  }
+}
+
+TEST_CASE("Truncated products") {
+
+  using namespace cbn;
+
+  constexpr auto a = pseudo_random_big_int<5>(1);
+  constexpr auto b = pseudo_random_big_int<3>(2);
+  static_assert(mul_low<3>(a, b) == detail::first<3>(mul(a, b)));
+  static_assert(mul_high<8>(a, b) == mul(a, b));
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto u = pseudo_random_big_int<7>(seed);
+    auto v = pseudo_random_big_int<4>(seed + 100);
+    auto uv = mul(u, v);
+
+    REQUIRE(mul_low<5>(u, v) == detail::first<5>(uv));
+    REQUIRE(mul_low<2>(v, u) == detail::first<2>(uv));
+
+    // mul_high may be off by one (from below)
+    auto high = mul_high<4>(u, v);
+    auto exact = detail::skip<7>(uv);
+    REQUIRE((high == exact || add_ignore_carry(high, big_int<4>{1}) == exact));
+
+    auto high1 = mul_high<1>(v, u);
+    auto exact1 = detail::skip<10>(uv);
+    REQUIRE((high1 == exact1 || add_ignore_carry(high1, big_int<1>{1}) == exact1));
+  }
+}
+
 TEST_CASE("Squaring") {
 
   using namespace cbn;
@@ -133,21 +466,23 @@ TEST_CASE("Squaring") {
   for (auto i = 0; i < trials; ++i) {
 
     big_int<4> x;
+    big_int<40> y;
     // randomize
-    auto sz = x.size();
-    for (auto j = 0; j < sz; ++j)
-      x[j] = distribution(generator);
-
-    //print("mul: ",mul(x,x)); 
-    //print("sq: ",square(x)); 
-    print ("iteration: ", i);
-    print ("x: ", x);
-    print ("sq: ", square(x));
-    print ("mul:", mul(x,x));
+    for (auto &limb : x)
+      limb = distribution(generator);
+    for (auto &limb : y)
+      limb = distribution(generator);
+
     REQUIRE(square(x) == mul(x, x));
+    REQUIRE(square(y) == mul(y, y));
+    REQUIRE(partial_square<3>(x) == partial_mul<3>(x, x));
+    REQUIRE(partial_square<40>(y) == partial_mul<40>(y, y));
   }
+
+  constexpr auto z = to_big_int(6513020836420374401749667047018991798096360820_Z);
+  static_assert(square(z) == mul(z, z));
+  static_assert(pow(z, uint64_t{3}) == partial_mul<3>(mul(z, z), z));
 }
-*/
 
 TEST_CASE("String Initialization") {
 
@@ -204,6 +539,41 @@ TEST_CASE("Barrett reduction") {
   static_assert(barrett_reduction(x, mod) == ans, "fail");
   REQUIRE(barrett_reduction(x, mod) == ans);
 
+  // inputs of full length (x < (2^64)^8)
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto y = pseudo_random_big_int<8>(seed);
+    REQUIRE(barrett_reduction(y, prime, mu) == div(y, prime).remainder);
+    REQUIRE(barrett_reduction(y, mod) == div(y, prime).remainder);
+  }
+}
+
+TEST_CASE("Wide reduction") {
+
+  using namespace cbn;
+
+  // p = 2^255 - 19
+  auto p = 57896044618658097711785492504343953926634992332820282019728792003956564819949_Z;
+  constexpr auto prime = to_big_int(p);
+  static_assert(wide_reduction(pseudo_random_big_int<16>(1), p) ==
+                div(pseudo_random_big_int<16>(1), prime).remainder);
+
+  auto ones = subtract_ignore_carry(big_int<16>{}, big_int<16>{1});
+  REQUIRE(wide_reduction(ones, p) == div(ones, prime).remainder);
+
+  auto q = 1606938044258990275541962092341162602522202993782792835301611_Z;
+  constexpr auto small_prime = to_big_int(q);
+  for (uint64_t seed = 0; seed < 20; ++seed) {
+    auto x = pseudo_random_big_int<8>(seed);
+    auto y = pseudo_random_big_int<16>(seed);
+    auto z = pseudo_random_big_int<41>(seed);
+    REQUIRE(wide_reduction(x, p) == div(x, prime).remainder);
+    REQUIRE(wide_reduction(y, p) == div(y, prime).remainder);
+    REQUIRE(wide_reduction(z, p) == div(z, prime).remainder);
+    REQUIRE(wide_reduction(detail::first<5>(x), p) == div(detail::first<5>(x), prime).remainder);
+    REQUIRE(wide_reduction(y, q) == div(y, small_prime).remainder);
+    REQUIRE(wide_reduction(detail::first<3>(y), q) ==
+            div(detail::first<3>(y), small_prime).remainder);
+  }
 }
 
 TEST_CASE("Montgomery reduction") {
@@ -215,6 +585,14 @@ TEST_CASE("Montgomery reduction") {
 
   static_assert(montgomery_reduction(T,modulus,mprime) == ans, "fail");
   REQUIRE(montgomery_reduction(T,modulus,mprime) == ans);
+
+  // shorter and longer inputs
+  static_assert(montgomery_reduction(detail::pad<3>(T), modulus, mprime) == ans);
+  constexpr auto x = to_big_int(924750812939937572408690850011_Z);
+  REQUIRE(montgomery_reduction(x, modulus, mprime) ==
+          montgomery_reduction(detail::pad<2>(x), modulus, mprime));
+  REQUIRE(montgomery_reduction(detail::pad<1>(x), modulus, mprime) ==
+          montgomery_mul(x, big_int<2>{1}, modulus, mprime));
 }
 
 
@@ -240,9 +618,268 @@ TEST_CASE("Montgomery mult") {
   auto modulus_seq = 1267650600228229401496703205653_Z;
 
   static_assert(montgomery_mul(x,y,modulus_seq) == ans);
+  static_assert(montgomery_sqr(x, modulus_seq) == montgomery_mul(x, x, modulus_seq));
+  static_assert(montgomery_sqr(x, modulus, mprime) == montgomery_mul(x, x, modulus, mprime));
+  REQUIRE(montgomery_sqr(y, modulus, mprime) == montgomery_mul(y, y, modulus, mprime));
   //static_assert(montgomery_mul2(x,y,modulus_seq) == ans);
 }
 
+template <size_t N> constexpr auto montgomery_mul_results() {
+  // evaluated at compile time, hence by the portable kernels
+  std::array<cbn::big_int<N>, 8> r{};
+  for (uint64_t seed = 0; seed < r.size(); ++seed) {
+    auto [m, x, y] = montgomery_mul_operands<N>(seed);
+    r[seed] = cbn::montgomery_mul(x, y, m, -cbn::detail::inverse_mod(m[0]));
+  }
+  return r;
+}
+
+TEST_CASE("Montgomery mult (random operands)") {
+  using namespace cbn;
+
+  constexpr auto expected4 = montgomery_mul_results<4>();
+  constexpr auto expected7 = montgomery_mul_results<7>();
+
+  for (uint64_t seed = 0; seed < 8; ++seed) {
+    auto [m4, x4, y4] = montgomery_mul_operands<4>(seed);
+    REQUIRE(montgomery_mul(x4, y4, m4, -detail::inverse_mod(m4[0])) ==
+            expected4[seed]);
+
+    auto [m7, x7, y7] = montgomery_mul_operands<7>(seed);
+    REQUIRE(montgomery_mul(x7, y7, m7, -detail::inverse_mod(m7[0])) ==
+            expected7[seed]);
+    REQUIRE(mul(x7, y7) == detail::schoolbook_mul(x7, y7));
+  }
+
+  constexpr auto x = to_big_int(924750812939937572408690850011_Z);
+  constexpr auto y = to_big_int(478633290783786461322094322310_Z);
+  constexpr auto modulus_seq = 1267650600228229401496703205653_Z;
+  constexpr auto ans = montgomery_mul(x, y, modulus_seq);
+  auto x_rt = x;
+  REQUIRE(montgomery_mul(x_rt, y, modulus_seq) == ans);
+
+  // NIST P-256 prime (has a zero limb)
+  constexpr auto p256 =
+      115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+  constexpr auto p = to_big_int(p256);
+  constexpr auto a = pseudo_random_big_int<4>(1) % p;
+  constexpr auto b = pseudo_random_big_int<4>(2) % p;
+  constexpr auto ab = montgomery_mul(a, b, p256);
+  constexpr auto pm1 = subtract_ignore_carry(p, big_int<4>{1});
+  constexpr auto pm1_sq = montgomery_mul(pm1, pm1, p256);
+  auto a_rt = a;
+  auto pm1_rt = pm1;
+  REQUIRE(montgomery_mul(a_rt, b, p256) == ab);
+  REQUIRE(montgomery_mul(pm1_rt, pm1, p256) == pm1_sq);
+
+  for (uint64_t seed = 0; seed < 8; ++seed) {
+    auto u = pseudo_random_big_int<8>(seed);
+    REQUIRE(square(u) == detail::schoolbook_partial_square<16>(u));
+    REQUIRE(square(detail::first<3>(u)) == detail::schoolbook_partial_square<6>(detail::first<3>(u)));
+  }
+}
+
+TEST_CASE("Independent Montgomery multiplications (x2/x4)") {
+  using namespace cbn;
+
+  constexpr auto p256 =
+      115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+  constexpr auto p = to_big_int(p256);
+  constexpr auto a = pseudo_random_big_int<4>(1) % p;
+  constexpr auto b = pseudo_random_big_int<4>(2) % p;
+  constexpr auto c = pseudo_random_big_int<4>(3) % p;
+  constexpr auto d = pseudo_random_big_int<4>(4) % p;
+  constexpr auto ab_cd = montgomery_mul_x2(a, b, c, d, p256);
+  static_assert(ab_cd[0] == montgomery_mul(a, b, p256));
+  static_assert(ab_cd[1] == montgomery_mul(c, d, p256));
+
+  auto a_rt = a;
+  auto [r0, r1, r2, r3] = montgomery_mul_x4(a_rt, b, b, c, c, d, d, a, p256);
+  REQUIRE(r0 == montgomery_mul(a, b, p256));
+  REQUIRE(r1 == montgomery_mul(b, c, p256));
+  REQUIRE(r2 == montgomery_mul(c, d, p256));
+  REQUIRE(r3 == montgomery_mul(d, a, p256));
+
+  for (uint64_t seed = 0; seed < 8; ++seed) {
+    auto [m, x, y] = montgomery_mul_operands<7>(seed);
+    auto u = pseudo_random_big_int<7>(seed + 100);
+    auto v = pseudo_random_big_int<7>(seed + 200);
+    u[6] %= m[6];
+    v[6] %= m[6];
+    uint64_t mprime = -detail::inverse_mod(m[0]);
+
+    auto [s0, s1] = montgomery_mul_x2(x, y, u, v, m, mprime);
+    REQUIRE(s0 == montgomery_mul(x, y, m, mprime));
+    REQUIRE(s1 == montgomery_mul(u, v, m, mprime));
+
+    auto [q0, q1, q2, q3] = montgomery_mul_x4(x, y, u, v, x, u, y, v, m, mprime);
+    REQUIRE(q0 == s0);
+    REQUIRE(q1 == s1);
+    REQUIRE(q2 == montgomery_mul(x, u, m, mprime));
+    REQUIRE(q3 == montgomery_mul(y, v, m, mprime));
+  }
+}
+
+TEST_CASE("In-place and out-parameter arithmetic") {
+  using namespace cbn;
+
+  constexpr auto p256 =
+      115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+  constexpr auto p = to_big_int(p256);
+
+  constexpr auto in_place = [](auto a, auto b) {
+    auto carry = add_to(a, b);
+    return detail::join(a, big_int<1>{carry});
+  };
+  static_assert(in_place(pseudo_random_big_int<4>(1), pseudo_random_big_int<3>(2)) ==
+                add(pseudo_random_big_int<4>(1), pseudo_random_big_int<3>(2)));
+
+  constexpr auto square_in_place = [](auto a) {
+    big_int<2 * a.size()> w{};
+    square_into(w, a);
+    return w;
+  };
+  static_assert(square_in_place(pseudo_random_big_int<24>(1)) ==
+                square(pseudo_random_big_int<24>(1)));
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto a = pseudo_random_big_int<5>(seed);
+    auto b = pseudo_random_big_int<3>(seed + 100);
+
+    auto s = a;
+    auto carry = add_to(s, b);
+    REQUIRE(detail::join(s, big_int<1>{carry}) == add(a, b));
+    auto borrow = sub_from(s, b);
+    REQUIRE(s == a);
+    REQUIRE(borrow == carry);
+
+    auto x = pseudo_random_big_int<4>(seed) % p;
+    auto y = pseudo_random_big_int<4>(seed + 200) % p;
+    auto z = x;
+    mod_add_to(z, y, p);
+    REQUIRE(z == mod_add(x, y, p));
+    mod_sub_from(z, y, p);
+    REQUIRE(z == x);
+    mod_add_to(z, z, p);
+    REQUIRE(z == mod_add(x, x, p));
+
+    big_int<9> w{};
+    w[8] = 1;
+    mul_into(w, b, a);
+    REQUIRE(w == detail::pad<1>(mul(b, a)));
+    square_into(w, b);
+    REQUIRE(w == detail::pad<3>(square(b)));
+
+    auto u = pseudo_random_big_int<40>(seed);
+    auto v = pseudo_random_big_int<30>(seed + 300);
+    big_int<70> uv;
+    mul_into(uv, u, v);
+    REQUIRE(uv == mul(u, v));
+
+    // Karatsuba squaring, and the unbalanced case, into longer outputs
+    big_int<81> uu{};
+    uu[80] = 1;
+    square_into(uu, u);
+    REQUIRE(uu == detail::pad<1>(square(u)));
+    auto t = pseudo_random_big_int<75>(seed + 400);
+    big_int<106> tv{};
+    mul_into(tv, v, t);
+    REQUIRE(tv == mul<1>(t, v));
+
+    big_int<300, uint32_t> u32{};
+    big_int<260, uint32_t> v32{};
+    for (auto i = 0U; i < 300; ++i) {
+      u32[i] = static_cast<uint32_t>(u[i % 40] >> (i % 32));
+      if (i < 260)
+        v32[i] = static_cast<uint32_t>(t[i % 75] >> (i % 29));
+    }
+    big_int<560, uint32_t> uv32;
+    mul_into(uv32, u32, v32);
+    REQUIRE(uv32 == mul(u32, v32));
+    big_int<600, uint32_t> uu32;
+    square_into(uu32, u32);
+    REQUIRE(uu32 == square(u32));
+
+    auto r = x;
+    montgomery_mul_into(r, r, y, p256);
+    REQUIRE(r == montgomery_mul(x, y, p256));
+    uint64_t mprime = -detail::inverse_mod(p[0]);
+    montgomery_mul_into(r, x, r, p, mprime);
+    REQUIRE(r == montgomery_mul(x, montgomery_mul(x, y, p, mprime), p, mprime));
+    auto rr = r;
+    montgomery_mul_into(r, r, r, p256);
+    REQUIRE(r == montgomery_mul(rr, rr, p256));
+    montgomery_mul_into(rr, x, y, p, mprime);
+    REQUIRE(rr == montgomery_mul(x, y, p, mprime));
+  }
+}
+
+TEST_CASE("Views of external limbs") {
+  using namespace cbn;
+
+  constexpr auto p256 =
+      115792089210356248762697446949407573530086143415290314195533631308867097853951_Z;
+  constexpr auto p = to_big_int(p256);
+
+  constexpr auto sum_via_view = [](auto a, auto b) {
+    big_int_view v(a);
+    add_to(v, big_int_view(b));
+    return a;
+  };
+  static_assert(sum_via_view(big_int<2>{~0UL, 1}, big_int<2>{1, 2}) == big_int<2>{0, 4});
+
+  constexpr big_int<4> c{1, 2, 3, 4};
+  static_assert(detail::subview<1, 2>(c).load() == big_int<2>{2, 3});
+  static_assert(detail::subview<1, 1>(detail::subview<2, 2>(c))[0] == 4);
+
+  for (uint64_t seed = 0; seed < 10; ++seed) {
+    auto a = pseudo_random_big_int<4>(seed) % p;
+    auto b = pseudo_random_big_int<4>(seed + 100) % p;
+
+    // two numbers with interleaved limbs
+    std::vector<uint64_t> buffer(8);
+    for (auto i = 0U; i < 4; ++i) {
+      buffer[2 * i] = a[i];
+      buffer[2 * i + 1] = b[i];
+    }
+    big_int_view<4, uint64_t, 2> va(buffer.data());
+    big_int_view<4, const uint64_t, 2> vb(buffer.data() + 1);
+    REQUIRE(va.load() == a);
+    REQUIRE(big_int<4>(vb) == b);
+
+    mod_add_to(va, vb, p);
+    REQUIRE(va.load() == mod_add(a, b, p));
+    mod_sub_from(va, vb, p);
+    REQUIRE(va.load() == a);
+
+    montgomery_mul_into(va, va, vb, p256);
+    REQUIRE(va.load() == montgomery_mul(a, b, p256));
+    va.store(a);
+
+    std::vector<uint64_t> product(9, 1);
+    mul_into(big_int_view<8>(product.data()), va, b);
+    REQUIRE(big_int_view<8, const uint64_t>(product.data()).load() == mul(a, b));
+    REQUIRE(product[8] == 1);
+
+    auto c = pseudo_random_big_int<30>(seed);
+    std::vector<uint64_t> square(60);
+    square_into(big_int_view<60>(std::span<uint64_t, 60>(square)), big_int_view(c));
+    REQUIRE(big_int_view<60, const uint64_t>(square.data()).load() == cbn::square(c));
+
+    // Karatsuba multiplication and Montgomery multiplication into interleaved
+    // limbs
+    auto d = pseudo_random_big_int<25>(seed + 200);
+    std::vector<uint64_t> products(110);
+    big_int_view<55, uint64_t, 2> cd(products.data());
+    mul_into(cd, big_int_view(c), d);
+    REQUIRE(cd.load() == mul(c, d));
+    big_int_view<4, uint64_t, 2> ab(products.data() + 1);
+    montgomery_mul_into(ab, a, vb, p256);
+    REQUIRE(ab.load() == montgomery_mul(a, b, p256));
+    REQUIRE(cd.load() == mul(c, d));
+  }
+}
+
 TEST_CASE("Montgomery mult template deduction") {
   using namespace cbn;
   big_int<4> x;
@@ -314,6 +951,182 @@ TEST_CASE("short div") {
 
 }
 
+TEST_CASE("Division with precomputed reciprocals") {
+
+  using namespace cbn;
+
+  // 2-by-1 division, exhaustively for 8-bit limbs
+  bool all_correct = true;
+  for (unsigned d = 128; d < 256; ++d) {
+    auto v = detail::reciprocal_word(static_cast<uint8_t>(d));
+    for (unsigned u1 = 0; u1 < d; ++u1)
+      for (unsigned u0 = 0; u0 < 256; ++u0) {
+        uint8_t r;
+        auto q = detail::div_2by1<uint8_t>(u1, u0, d, v, r);
+        all_correct &= (q == (u1 * 256 + u0) / d) && (r == (u1 * 256 + u0) % d);
+      }
+  }
+  REQUIRE(all_correct);
+
+  // 3-by-2 division, for 8-bit limbs
+  for (uint64_t seed = 0; seed < 2000; ++seed) {
+    auto x = pseudo_random_big_int<1>(seed)[0];
+    uint32_t d = (x & 0x7fff) | 0x8000;
+    uint32_t u = (x >> 16) % (d << 8);
+    uint8_t r1, r0;
+    auto v = detail::reciprocal_3by2<uint8_t>(d >> 8, d);
+    auto q = detail::div_3by2<uint8_t>(u >> 16, u >> 8, u, d >> 8, d, v, r1, r0);
+    REQUIRE(q == u / d);
+    REQUIRE(uint32_t(r1) * 256 + r0 == u % d);
+  }
+
+  // q v + r = u, r < v
+  auto check = [](auto u, auto v) {
+    auto qr = div(u, v);
+    REQUIRE(qr.remainder < v);
+    REQUIRE(detail::to_length<u.size() + 1>(add(mul(qr.quotient, v), qr.remainder)) ==
+            detail::pad<1>(u));
+  };
+  for (uint64_t seed = 0; seed < 50; ++seed) {
+    auto u = pseudo_random_big_int<9>(seed);
+    auto v = pseudo_random_big_int<4>(seed + 100);
+    check(u, v);
+    v[3] >>= seed % 64; // not normalized
+    check(u, v);
+    v[3] = 0;
+    check(u, v);
+    check(u, detail::first<1>(v));
+    check(u, big_int<2>{v[0], 1});
+
+    // the case where the top limbs of the partial remainder equal those of
+    // the divisor (the quotient limb is B - 1)
+    auto w = pseudo_random_big_int<3>(seed + 200);
+    w[2] |= uint64_t(1) << 63;
+    w[0] |= 1;
+    check(big_int<4>{u[0], w[0] - 1, w[1], w[2]}, w);
+    check(subtract_ignore_carry(detail::join(big_int<2>{}, w), big_int<5>{1}), w);
+    check(detail::join(pseudo_random_big_int<1>(seed), detail::join(w, w)), w);
+
+    big_int<7, uint32_t> a{};
+    big_int<3, uint32_t> b{};
+    for (auto i = 0U; i < 7; ++i)
+      a[i] = static_cast<uint32_t>(u[i] >> 7);
+    for (auto i = 0U; i < 3; ++i)
+      b[i] = static_cast<uint32_t>(v[i] >> (seed % 32));
+    b[2] |= 1;
+    check(a, b);
+  }
+  static_assert(div(pseudo_random_big_int<9>(1), pseudo_random_big_int<4>(2)).remainder ==
+                pseudo_random_big_int<9>(1) % pseudo_random_big_int<4>(2));
+}
+
+TEST_CASE("Exact division and 2-adic inverses") {
+
+  using namespace cbn;
+
+  constexpr auto a = pseudo_random_big_int<5>(2); // odd
+  static_assert(partial_mul<5>(a, inverse_mod_2k(a)) == big_int<5>{1});
+  static_assert(exact_div(mul(a, pseudo_random_big_int<3>(3)), a) ==
+                detail::pad<5>(pseudo_random_big_int<3>(3)));
+
+  auto check_inverse = [](auto x) {
+    x[0] |= 1;
+    REQUIRE(partial_mul<x.size()>(x, inverse_mod_2k(x)) == decltype(x){1});
+  };
+
+  // a d / d = a
+  auto check = [](auto q, auto d) {
+    auto u = mul(q, d);
+    REQUIRE(exact_div(u, d) == detail::pad<d.size()>(q));
+    REQUIRE(exact_div(u, q) == detail::pad<q.size()>(d));
+  };
+
+  for (uint64_t seed = 0; seed < 50; ++seed) {
+    check_inverse(pseudo_random_big_int<1>(seed));
+    check_inverse(pseudo_random_big_int<2>(seed));
+    check_inverse(pseudo_random_big_int<3>(seed));
+    check_inverse(pseudo_random_big_int<8>(seed));
+    check_inverse(big_int<5, uint8_t>{static_cast<uint8_t>(seed), 7, 0, 255, 1});
+
+    auto q = pseudo_random_big_int<5>(seed);
+    auto d = pseudo_random_big_int<3>(seed + 100);
+    check(q, d);
+    d[0] &= ~uint64_t{0} << (seed % 64); // even divisors
+    check(q, d);
+    d[0] = 0;
+    check(q, d);
+    d[2] = 0;
+    check(q, d);
+    check(q, big_int<2>{d[1] >> 11, 0});
+    check(q, big_int<1>{uint64_t{1} << (seed % 64)});
+    check(q, big_int<1>{1});
+    REQUIRE(exact_div(big_int<8>{}, d) == big_int<8>{});
+
+    big_int<6, uint32_t> x{};
+    big_int<3, uint32_t> y{};
+    for (auto i = 0U; i < 6; ++i)
+      x[i] = static_cast<uint32_t>(q[i % 5] >> 9);
+    for (auto i = 0U; i < 3; ++i)
+      y[i] = static_cast<uint32_t>(d[i] >> (seed % 32));
+    check(x, y);
+  }
+}
+
+
+TEST_CASE("Reciprocals") {
+
+  using namespace cbn;
+
+  // a X < (2^w)^(2 N) <= a (X + 2), by Newton iteration
+  auto check_approx = [](auto a) {
+    constexpr auto N = a.size();
+    a[N - 1] |= uint64_t(1) << 63;
+    auto x = detail::approx_reciprocal(a);
+    auto pow = detail::unary_encoding<2 * N, 2 * N + 2>();
+    REQUIRE(detail::pad<1>(mul(a, x)) < pow);
+    REQUIRE(mul(a, add(x, big_int<1>{2})) >= pow);
+  };
+
+  // mu = floor((2^w)^(2 N) / m), and (2^w)^(2 N) mod m
+  auto check = [](auto m) {
+    constexpr auto N = m.size();
+    auto qr = div(detail::unary_encoding<2 * N, 2 * N + 1>(), m);
+    auto rec = reciprocal(m);
+    REQUIRE(rec.quotient == detail::first<N + 1>(qr.quotient));
+    REQUIRE(rec.remainder == qr.remainder);
+  };
+
+  for (uint64_t seed = 0; seed < 20; ++seed) {
+    check_approx(pseudo_random_big_int<1>(seed));
+    check_approx(pseudo_random_big_int<3>(seed));
+    check_approx(pseudo_random_big_int<4>(seed));
+    check_approx(pseudo_random_big_int<9>(seed));
+    check_approx(pseudo_random_big_int<40>(seed));
+    check_approx(big_int<5>{seed});
+    check_approx(subtract_ignore_carry(big_int<6>{}, big_int<6>{seed + 1}));
+
+    auto m = pseudo_random_big_int<4>(seed);
+    check(m);
+    m[3] >>= seed;
+    check(m);
+
+    auto n = pseudo_random_big_int<160>(seed);
+    n[159] >>= seed;
+    check(n);
+  }
+
+  // moduli whose most-significant limb is zero (only the remainder is exact,
+  // the quotient is truncated to N + 1 limbs)
+  auto m = pseudo_random_big_int<4>(1);
+  m[3] = 0;
+  check(m);
+  auto n = pseudo_random_big_int<160>(1);
+  n[159] = 0;
+  check(n);
+  n[158] = 0;
+  n[0] |= 1;
+  REQUIRE(mod_exp(big_int<1>{3}, big_int<1>{5}, n) == big_int<160>{243});
+}
 
 TEST_CASE("gcd") {
 
@@ -431,6 +1244,42 @@ TEST_CASE("Modular Exponentiation") {
 
 }
 
+TEST_CASE("Montgomery context") {
+
+  using namespace cbn;
+
+  constexpr auto x = to_big_int(123512321638732781541098374832654_Z);
+  constexpr auto e = to_big_int(1180591620739245727853_Z);
+  constexpr auto m = to_big_int(85070591730234618820156358408775751693_Z);
+  constexpr auto ans = to_big_int(65447949695390573931730737899088862792_Z);
+
+  constexpr montgomery_context ctx{m};
+  static_assert(static_cast<uint64_t>(ctx.mprime * m[0]) == uint64_t(-1));
+  static_assert(ctx.mu == detail::first<3>(div(detail::unary_encoding<4, 5>(), m).quotient));
+  static_assert(ctx.from_montgomery(ctx.to_montgomery(x)) == x);
+  static_assert(mod_exp(x, e, ctx) == ans);
+  REQUIRE(mod_exp(x, e, ctx) == ans);
+  REQUIRE(mod_exp(x, e, m) == ans);
+
+  auto y = to_big_int(478633290783786461322094322310_Z);
+  auto xm = to_montgomery(x, ctx);
+  auto ym = to_montgomery(y, ctx);
+  REQUIRE(from_montgomery(montgomery_mul(xm, ym, ctx), ctx) == mul(x, y) % m);
+  REQUIRE(ctx.sqr(xm) == ctx.mul(xm, xm));
+  REQUIRE(montgomery_reduction(mul(xm, ym), ctx) == ctx.mul(xm, ym));
+  REQUIRE(mod_add(x, y, ctx) == mod_add(x, y, m));
+  REQUIRE(mod_sub(x, y, ctx) == mod_sub(x, y, m));
+  REQUIRE(barrett_reduction(mul(x, y), ctx) == mul(x, y) % m);
+  REQUIRE(mod_inv(x, ctx) == mod_inv(x, m));
+  REQUIRE(mul(mod_inv(x, ctx), x) % m == big_int<1>{1});
+
+  // a modulus whose most-significant limb is zero
+  const montgomery_context short_ctx{detail::pad<1>(m)};
+  const auto xy = mul(detail::pad<1>(x), detail::pad<1>(y));
+  REQUIRE(barrett_reduction(xy, short_ctx) == xy % m);
+  REQUIRE(mod_exp(x, e, short_ctx) == detail::pad<1>(ans));
+}
+
 TEST_CASE("summation") {
 
   using namespace cbn;